@@ -0,0 +1,426 @@
+/**
+ * @file benchmark.cpp
+ * @brief Benchmarks of the SECS hot paths
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * Runs every workload at each entity count up to BENCH_MAX_ENTITIES and
+ * prints the time per entity and the peak memory SECS allocated during the
+ * workload. Each run gets a fresh World, so runs do not share storage.
+ *
+ * - **create (lambda)**: World::CreateEntity(Lambda) with two components
+ * - **create (types)**: World::CreateEntity<Ts...>() with two components
+ * - **destroy**: EntityReference::Destroy() of every entity, in random order
+ * - **churn**: Destroying a random entity and creating a new one
+ * - **iterate N**: EntityIterator::Iterate() over N of eight components
+ * - **fragmented**: Iterate() over two components spread across 64 archetypes
+ * - **random access**: EntityReference::Access() of entities in random order
+ * - **view access**: View::Access() of the same entities, through cached pointers
+ * - **migrate**: Adding then removing a component, moving the entity twice
+ * - **hierarchy**: IterateHierarchy() propagating a value down a binary tree
+ *
+ * Memory is measured through SECS_ALLOCATOR, so every byte SECS obtains is
+ * counted. Times come from BENCH_CLOCK, a type with a static `uint64_t Now()`
+ * returning nanoseconds, which defaults to std::chrono::steady_clock. Cross
+ * targets without it define their own clock, see the Makefile.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef BENCH_MAX_ENTITIES
+#define BENCH_MAX_ENTITIES 100000
+#endif
+
+#ifndef BENCH_CLOCK
+#include <chrono>
+
+/**
+ * @brief Clock used when BENCH_CLOCK is not defined.
+ */
+struct SteadyNanoseconds
+{
+    static uint64_t Now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+#define BENCH_CLOCK SteadyNanoseconds
+#endif
+
+/**
+ * @brief Allocator forwarding to malloc() while keeping track of the peak usage.
+ */
+struct TrackingAllocator
+{
+    static inline size_t used = 0;
+    static inline size_t peak = 0;
+
+    static void* Allocate(size_t size, size_t alignment)
+    {
+        (void)alignment;
+        void* ptr = malloc(size);
+        if (ptr)
+        {
+            used += size;
+            peak = (used > peak) ? used : peak;
+        }
+        return ptr;
+    }
+
+    static void Deallocate(void* ptr, size_t size)
+    {
+        if (ptr) { used -= size; }
+        free(ptr);
+    }
+};
+
+#define SECS_ALLOCATOR ::TrackingAllocator
+#include <secs.hpp>
+
+using namespace SECS;
+
+template <size_t I>
+struct Field { float value[2]; };
+
+using Position = Field<0>;
+using Velocity = Field<1>;
+
+template <size_t I>
+struct Variant {};
+
+/**
+ * @brief Deterministic xorshift generator, so that every build visits entities in the same order.
+ */
+struct Random
+{
+    uint32_t state = 2463534242u;
+
+    uint32_t Next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    size_t Below(size_t bound) { return Next() % bound; }
+};
+
+/**
+ * @brief Time per entity and peak memory of one workload at one entity count.
+ */
+struct Result
+{
+    double nsPerEntity = 0.0;
+    size_t peakBytes = 0;
+};
+
+static volatile float sink;
+
+/**
+ * @brief Run a workload in a fresh world.
+ * @param count The number of entities the workload handles.
+ * @param setup The untimed preparation, taking the world entities are created in.
+ * @param body The timed part, returning the number of entity operations it did.
+ * @return The time per entity operation and the peak memory allocated since the world was created.
+ */
+template <typename Setup, typename Body>
+static Result Measure(Setup setup, Body body)
+{
+    Result result;
+    {
+        World world;
+        World::Scope scope(world);
+
+        const size_t baseline = TrackingAllocator::used;
+        TrackingAllocator::peak = baseline;
+
+        setup();
+        const uint64_t start = BENCH_CLOCK::Now();
+        const size_t operations = body();
+        const uint64_t elapsed = BENCH_CLOCK::Now() - start;
+
+        result.nsPerEntity = operations ? double(elapsed) / double(operations) : 0.0;
+        result.peakBytes = TrackingAllocator::peak - baseline;
+    }
+    return result;
+}
+
+/**
+ * @brief Create entities with every one of the eight Field components.
+ * @param count The number of entities.
+ * @param references Receives a reference to each entity, may be nullptr.
+ */
+static void CreateWide(size_t count, EntityReference* references)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        EntityReference entity = World::CreateEntity([i](Field<0>* a, Field<1>* b, Field<2>*, Field<3>*,
+            Field<4>*, Field<5>*, Field<6>*, Field<7>* h)
+        {
+            a->value[0] = float(i);
+            b->value[0] = 1.0f;
+            h->value[0] = 2.0f;
+        });
+        if (references) { references[i] = entity; }
+    }
+}
+
+/**
+ * @brief Shuffle references so that accesses do not follow storage order.
+ */
+static void Shuffle(EntityReference* references, size_t count, Random& random)
+{
+    for (size_t i = count; i > 1; --i)
+    {
+        const size_t j = random.Below(i);
+        EntityReference swapped = references[i - 1];
+        references[i - 1] = references[j];
+        references[j] = swapped;
+    }
+}
+
+/**
+ * @brief Create an entity in one of 64 archetypes sharing Position and Velocity.
+ */
+static void CreateVariant(size_t variant)
+{
+    EntityReference entity = World::CreateEntity([](Position* pos, Velocity* vel)
+    {
+        pos->value[0] = 0.0f;
+        vel->value[0] = 1.0f;
+    });
+
+    if (variant & 1) { entity.Add<Variant<0>>(); }
+    if (variant & 2) { entity.Add<Variant<1>>(); }
+    if (variant & 4) { entity.Add<Variant<2>>(); }
+    if (variant & 8) { entity.Add<Variant<3>>(); }
+    if (variant & 16) { entity.Add<Variant<4>>(); }
+    if (variant & 32) { entity.Add<Variant<5>>(); }
+}
+
+static void Report(const char* name, size_t count, const Result& result)
+{
+    printf("%-16s %9zu %12.2f %12.1f\n", name, count, result.nsPerEntity, double(result.peakBytes) / 1024.0);
+}
+
+int main()
+{
+    static const size_t scales[] = { 1000, 10000, 100000 };
+    const size_t passes = 16;
+
+    printf("%-16s %9s %12s %12s\n", "workload", "entities", "ns/entity", "peak KB");
+
+    for (size_t count : scales)
+    {
+        if (count > BENCH_MAX_ENTITIES) { break; }
+        if (count > IndexLimit)
+        {
+            printf("%zu entities exceed the Index range, build with SECS_INDEX_BITS=32\n", count);
+            break;
+        }
+
+        EntityReference* references = new EntityReference[count];
+        Random random;
+
+        Report("create (lambda)", count, Measure([] {}, [count]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                World::CreateEntity([i](Position* pos, Velocity* vel)
+                {
+                    pos->value[0] = float(i);
+                    vel->value[0] = 1.0f;
+                });
+            }
+            return count;
+        }));
+
+        Report("create (types)", count, Measure([] {}, [count]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                World::CreateEntity<Position, Velocity>();
+            }
+            return count;
+        }));
+
+        Report("destroy", count, Measure([count, references, &random]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                references[i] = World::CreateEntity<Position, Velocity>();
+            }
+            Shuffle(references, count, random);
+        }, [count, references]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                references[i].Destroy();
+            }
+            return count;
+        }));
+
+        Report("churn", count, Measure([count, references]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                references[i] = World::CreateEntity<Position, Velocity>();
+            }
+        }, [count, references, &random]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const size_t slot = random.Below(count);
+                references[slot].Destroy();
+                references[slot] = World::CreateEntity<Position, Velocity>();
+            }
+            return count;
+        }));
+
+        Report("iterate 1", count, Measure([count] { CreateWide(count, nullptr); }, [count, passes]
+        {
+            World::EntityIterator it;
+            float total = 0.0f;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                it.Iterate([&total](const Field<0>* a) { total += a->value[0]; });
+            }
+            sink = total;
+            return count * passes;
+        }));
+
+        Report("iterate 3", count, Measure([count] { CreateWide(count, nullptr); }, [count, passes]
+        {
+            World::EntityIterator it;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                it.Iterate([](Field<0>* a, const Field<1>* b, const Field<2>* c)
+                {
+                    a->value[0] += b->value[0] * c->value[1];
+                });
+            }
+            return count * passes;
+        }));
+
+        Report("iterate 8", count, Measure([count] { CreateWide(count, nullptr); }, [count, passes]
+        {
+            World::EntityIterator it;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                it.Iterate([](Field<0>* a, const Field<1>* b, const Field<2>* c, const Field<3>* d,
+                    const Field<4>* e, const Field<5>* f, const Field<6>* g, const Field<7>* h)
+                {
+                    a->value[0] += b->value[0] + c->value[0] + d->value[0] + e->value[0] + f->value[0] +
+                        g->value[0] + h->value[0];
+                });
+            }
+            return count * passes;
+        }));
+
+        Report("fragmented", count, Measure([count]
+        {
+            for (size_t i = 0; i < count; ++i) { CreateVariant(i % 64); }
+        }, [count, passes]
+        {
+            World::EntityIterator it;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                it.Iterate([](Position* pos, const Velocity* vel) { pos->value[0] += vel->value[0]; });
+            }
+            return count * passes;
+        }));
+
+        Report("random access", count, Measure([count, references, &random]
+        {
+            CreateWide(count, references);
+            Shuffle(references, count, random);
+        }, [count, references]
+        {
+            float total = 0.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                references[i].Access([&total](const Field<0>* a, const Field<7>* h) { total += a->value[0] + h->value[0]; });
+            }
+            sink = total;
+            return count;
+        }));
+
+        Report("view access", count, Measure([count, references, &random]
+        {
+            CreateWide(count, references);
+            Shuffle(references, count, random);
+        }, [count, references, passes]
+        {
+            View<const Field<0>, const Field<7>>* views = new View<const Field<0>, const Field<7>>[count];
+            for (size_t i = 0; i < count; ++i)
+            {
+                views[i] = View<const Field<0>, const Field<7>>(references[i]);
+                views[i].Access([](const Field<0>*) {});
+            }
+
+            float total = 0.0f;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    views[i].Access([&total](const Field<0>* a, const Field<7>* h) { total += a->value[0] + h->value[0]; });
+                }
+            }
+            sink = total;
+            delete[] views;
+            return count * passes;
+        }));
+
+        Report("migrate", count, Measure([count, references]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                references[i] = World::CreateEntity<Position, Velocity, Field<2>>();
+            }
+        }, [count, references]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                references[i].Add<Field<3>>();
+                references[i].Remove<Field<3>>();
+            }
+            return count * 2;
+        }));
+
+        Report("hierarchy", count, Measure([count, references]
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                references[i] = World::CreateEntity<Position, Velocity>();
+            }
+            for (size_t i = count - 1; i > 0; --i)
+            {
+                World::SetParent(references[i], references[(i - 1) / 2]);
+            }
+            World::SortHierarchy();
+        }, [count, passes]
+        {
+            World::EntityIterator it;
+            for (size_t pass = 0; pass < passes; ++pass)
+            {
+                it.IterateHierarchy([](const Position* parent, const Velocity* local, Position* world)
+                {
+                    world->value[0] = (parent ? parent->value[0] : 0.0f) + local->value[0];
+                });
+            }
+            return count * passes;
+        }));
+
+        delete[] references;
+    }
+
+    return 0;
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+/**
+ * @file Allocator.hpp
+ * @brief Memory allocation hook for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * Every byte of storage used by SECS (entity records, component columns,
+ * archetype tables and internal containers) is obtained through the allocator
+ * type selected by SECS_ALLOCATOR. This makes it possible to back the whole
+ * library with a static arena or any other fixed memory pool, giving
+ * deterministic memory usage and keeping the general-purpose heap free of
+ * fragmentation.
+ *
+ * An allocator is a type exposing two static functions:
+ * ```cpp
+ * struct MyAllocator
+ * {
+ *     // Return nullptr when out of memory, never throw
+ *     static void* Allocate(size_t size, size_t alignment);
+ *     static void Deallocate(void* ptr, size_t size);
+ * };
+ *
+ * #define SECS_ALLOCATOR MyAllocator
+ * #include <secs.hpp>
+ * ```
+ *
+ * @par Failure Handling:
+ * Allocation failures of entity or component storage are reported the usual
+ * SECS way: entity creation returns an invalid EntityReference and component
+ * additions return false. Internal bookkeeping containers (archetype list,
+ * transition edges, query caches) are small but cannot report failure, they
+ * call SECS_OUT_OF_MEMORY() instead, which aborts by default. An allocator
+ * should always keep room for them.
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see Config.hpp For SECS_ALLOCATOR
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+#include "Config.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Allocator used when SECS_ALLOCATOR is not defined
+     *
+     * @details
+     * Forwards to malloc() and free(). The returned memory is suitably aligned
+     * for any fundamental type, over-aligned component types need a custom allocator.
+     */
+    struct DefaultAllocator
+    {
+        /**
+         * @brief Allocates a block of memory.
+         * @param size The number of bytes to allocate.
+         * @param alignment The required alignment of the block.
+         * @return A pointer to the block, or nullptr on failure.
+         */
+        static void* Allocate(size_t size, size_t alignment)
+        {
+            (void)alignment;
+            return malloc(size);
+        }
+
+        /**
+         * @brief Releases a block of memory.
+         * @param ptr Pointer to the block, may be nullptr.
+         * @param size The size of the block in bytes.
+         */
+        static void Deallocate(void* ptr, size_t size)
+        {
+            (void)size;
+            free(ptr);
+        }
+    };
+
+    /**
+     * @brief Bump allocator over a statically allocated buffer
+     *
+     * @details
+     * Allocations are carved linearly out of a fixed buffer, which makes them
+     * O(1) and fully deterministic. Only the most recent allocation can be given
+     * back; other deallocations are ignored until Reset(). This suits data
+     * whose lifetime is bounded by a level or a frame.
+     *
+     * @tparam Capacity The size of the buffer in bytes.
+     * @tparam Tag Optional type to create several independent arenas of the same capacity.
+     *
+     * @par Example:
+     * ```cpp
+     * // The macro is expanded inside SECS, after ArenaAllocator is declared
+     * #define SECS_ALLOCATOR SECS::ArenaAllocator<512 * 1024>
+     * #include <secs.hpp>
+     * ```
+     *
+     * @warning Reset() invalidates every allocation made from the arena, it must
+     *          only be called once nothing allocated from it is in use anymore.
+     */
+    template <size_t Capacity, typename Tag = void>
+    class ArenaAllocator
+    {
+        alignas(max_align_t) static inline uint8_t buffer[Capacity];
+        static inline size_t used = 0;
+
+    public:
+        /**
+         * @brief Allocates a block of memory from the arena.
+         * @param size The number of bytes to allocate.
+         * @param alignment The required alignment of the block, must be a power of two.
+         * @return A pointer to the block, or nullptr if the arena is exhausted.
+         */
+        static void* Allocate(size_t size, size_t alignment)
+        {
+            uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+            size_t offset = static_cast<size_t>(((base + used + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base);
+
+            if (offset > Capacity || size > Capacity - offset)
+            {
+                return nullptr;
+            }
+
+            used = offset + size;
+            return buffer + offset;
+        }
+
+        /**
+         * @brief Gives back a block if it is the most recent allocation.
+         * @param ptr Pointer to the block, may be nullptr.
+         * @param size The size of the block in bytes.
+         */
+        static void Deallocate(void* ptr, size_t size)
+        {
+            if (ptr && static_cast<uint8_t*>(ptr) + size == buffer + used)
+            {
+                used -= size;
+            }
+        }
+
+        /**
+         * @brief Releases every allocation made from the arena.
+         */
+        static void Reset() { used = 0; }
+
+        /**
+         * @brief Retrieves the number of bytes currently in use.
+         * @return The number of bytes in use, including alignment padding.
+         */
+        static size_t Used() { return used; }
+    };
+
+    /**
+     * @brief The allocator selected through SECS_ALLOCATOR.
+     */
+    using Allocator = SECS_ALLOCATOR;
+
+    /**
+     * @brief Typed helpers over the selected allocator
+     *
+     * @details
+     * These functions only manage raw memory, constructing and destroying
+     * objects is left to the caller.
+     */
+    struct Memory
+    {
+        /**
+         * @brief Allocates uninitialized storage for an array.
+         * @tparam T The type of the array elements.
+         * @param count The number of elements.
+         * @return A pointer to the storage, or nullptr on failure.
+         */
+        template <typename T>
+        static T* Allocate(size_t count)
+        {
+            return static_cast<T*>(Allocator::Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        /**
+         * @brief Releases storage obtained from Allocate().
+         * @tparam T The type of the array elements.
+         * @param ptr Pointer to the storage, may be nullptr.
+         * @param count The number of elements the storage was allocated for.
+         */
+        template <typename T>
+        static void Deallocate(T* ptr, size_t count)
+        {
+            if (ptr)
+            {
+                Allocator::Deallocate(ptr, sizeof(T) * count);
+            }
+        }
+
+        /**
+         * @brief Resizes storage for an array of trivially copyable elements.
+         * @details On failure the original storage is left untouched.
+         * @tparam T The type of the array elements.
+         * @param ptr Pointer to the storage, may be nullptr.
+         * @param oldCount The number of elements the storage was allocated for.
+         * @param newCount The new number of elements.
+         * @return A pointer to the resized storage, or nullptr on failure.
+         */
+        template <typename T>
+        static T* Reallocate(T* ptr, size_t oldCount, size_t newCount)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Reallocate requires trivially copyable elements");
+
+            T* newPtr = Allocate<T>(newCount);
+            if (newPtr && ptr)
+            {
+                memcpy(newPtr, ptr, sizeof(T) * ((oldCount < newCount) ? oldCount : newCount));
+                Deallocate(ptr, oldCount);
+            }
+            return newPtr;
+        }
+    };
+
+    /**
+     * @brief Standard library allocator adapter over the selected allocator
+     * @details Containers never see a failed allocation, SECS_OUT_OF_MEMORY() is called instead.
+     * @tparam T The type of the allocated elements.
+     */
+    template <typename T>
+    struct StdAllocator
+    {
+        using value_type = T;
+
+        constexpr StdAllocator() noexcept = default;
+
+        template <typename U>
+        constexpr StdAllocator(const StdAllocator<U>&) noexcept {}
+
+        T* allocate(size_t count)
+        {
+            T* ptr = Memory::Allocate<T>(count);
+            if (!ptr)
+            {
+                SECS_OUT_OF_MEMORY();
+                abort();
+            }
+            return ptr;
+        }
+
+        void deallocate(T* ptr, size_t count) { Memory::Deallocate(ptr, count); }
+
+        template <typename U>
+        constexpr bool operator==(const StdAllocator<U>&) const noexcept { return true; }
+
+        template <typename U>
+        constexpr bool operator!=(const StdAllocator<U>&) const noexcept { return false; }
+    };
+
+    /**
+     * @brief std::vector drawing its storage from the selected allocator.
+     * @tparam T The type of the elements.
+     */
+    template <typename T>
+    using Vector = std::vector<T, StdAllocator<T>>;
+}
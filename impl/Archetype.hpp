@@ -47,6 +47,16 @@
  * This Structure of Arrays (SoA) layout maximizes cache efficiency during
  * system iteration compared to Array of Structures (AoS) approaches.
  * 
+ * @par Chunked Storage:
+ * When SECS_CHUNK_SIZE is non-zero, each archetype stores its rows in
+ * fixed-size chunks instead of growing contiguous arrays:
+ * ```
+ * Chunk 0: [ent0..ent127][pos0..pos127][vel0..vel127]
+ * Chunk 1: [ent128..    ][pos128..    ][vel128..    ]
+ * ```
+ * Growth allocates one chunk, so rows never move on insert and component
+ * pointers stay stable until the row itself is removed or migrated.
+ * 
  * @par Thread Safety:
  * This class is NOT thread-safe. External synchronization is required
  * for multi-threaded access.
@@ -63,10 +73,17 @@
 
 #include <stdint.h>
 #include <stddef.h>
-#include <vector>
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include <bit>
 
+#include "Config.hpp"
+#include "Allocator.hpp"
 #include "EntityRecord.hpp"
 #include "Component.hpp"
+#include "SparseSet.hpp"
+#include "Stats.hpp"
 #include "Utils.hpp"
 
 namespace SECS
@@ -76,13 +93,13 @@ namespace SECS
      * 
      * @details
      * This concept ensures that component types meet the basic requirements
-     * for use in the SECS Entity Component System. Currently, the only
-     * requirement is that component types must not be empty classes.
+     * for use in the SECS Entity Component System. Empty types are valid and
+     * act as tags, see TagComponent.
      * 
      * @tparam T The component type to validate
      * 
      * @par Requirements:
-     * - Must not be an empty class (sizeof(T) > 0)
+     * - Must be an object type
      * - Should be trivially copyable for optimal performance
      * - Should avoid dynamic allocations for Saturn compatibility
      * 
@@ -91,11 +108,11 @@ namespace SECS
      * struct Position { float x, y; };           // Valid: has data members
      * struct Velocity { float dx, dy; };         // Valid: has data members
      * struct Health { uint16_t current, max; };  // Valid: has data members
+     * struct Enemy {};                           // Valid: tag
      * ```
      * 
      * @par Invalid Component Examples:
      * ```cpp
-     * struct EmptyTag {};                        // Invalid: empty class
      * class AbstractComponent { virtual ~AbstractComponent() = 0; }; // Avoid: virtual
      * ```
      * 
@@ -106,7 +123,38 @@ namespace SECS
      * @see ArchetypeManager For component storage and management
      */
     template <typename T>
-    concept ComponentType = !std::is_empty_v<T>;
+    concept ComponentType = std::is_object_v<T>;
+
+    /**
+     * @brief Concept identifying tag components
+     * 
+     * @details
+     * Tags are empty component types such as `struct Enemy {};`. A tag takes
+     * up a bit in the archetype binary identifier, so it counts toward archetype
+     * identity and queries, but it never gets a column: tags cost no memory per
+     * entity and nothing when entities are moved. Lambdas taking a tag receive a
+     * pointer to a single instance shared by every entity; prefer the With<Tag>
+     * query filter when only the presence of the tag matters.
+     * 
+     * @tparam T The component type to check
+     */
+    template <typename T>
+    concept TagComponent = ComponentType<T> && std::is_empty_v<T>;
+
+    template <typename... Filters>
+    struct QueryFilter;
+
+    template <typename... Ts>
+    struct With;
+
+    template <typename... Ts>
+    struct Without;
+
+    template <typename... Ts>
+    struct Optional;
+
+    template <typename... Ts>
+    struct Changed;
 
     /**
      * @brief Manages archetype-based component storage and entity organization
@@ -138,6 +186,7 @@ namespace SECS
      * 
      * @par Memory Management:
      * - Component arrays grow dynamically as entities are added
+     * - All storage is obtained through the SECS_ALLOCATOR hook
      * - Removed entities leave gaps that are filled by moving the last entity
      * - No memory fragmentation within component arrays
      * - Automatic cleanup when archetypes become empty
@@ -159,19 +208,144 @@ namespace SECS
     {
         friend class EntityReference;
         friend class World;
+        friend class CommandBuffer;
+        friend class Snapshot;
+        template <typename...> friend class Schedule;
+        template <typename...> friend class View;
+        template <typename...> friend struct With;
+        template <typename...> friend struct Without;
+        template <typename...> friend struct Optional;
+        template <typename...> friend struct Changed;
+
+        /**
+         * @brief Archetypes matched by one query, see LookupCacheImplementation.
+         */
+        struct QueryCache
+        {
+            size_t lastIndexChecked = 0;
+            Vector<Index> matchedIndices;
+            Vector<Index> activeIndices;    /**< Matched archetypes holding entities. */
+            size_t activeEpoch = 0;         /**< occupancyEpoch the active view was built for. */
+#if SECS_ENABLE_STATS
+            QueryStats stats;
+#endif
+        };
+
+        /**
+         * @brief A range of rows of one archetype run by one job of a dispatch, see World::IterateParallel().
+         */
+        struct Job
+        {
+            ArchetypeManager* manager;
+            Index begin;
+            Index end;
+            uint32_t systems;               /**< Systems of the Schedule stage running on the rows, 0 for World::IterateParallel(). */
+        };
+
+        /**
+         * @brief The archetypes of one world and everything cached about them.
+         */
+        struct Storage
+        {
+            Vector<ArchetypeManager> managers;
+            size_t structuralLocks = 0;     /**< Number of dispatches in progress that forbid structural changes. */
+            size_t occupancyEpoch = 0;      /**< Bumped whenever an archetype becomes empty or non-empty, or moves its storage. */
+            uint32_t changeTick = 1;        /**< Tick stamped on written change blocks, advanced by each Changed<> iteration. */
+            Index lookupTable[SECS_ARCHETYPE_LOOKUP_SIZE] = {};   /**< Manager index + 1 per slot, 0 marks an empty slot. */
+            Vector<Index> helperIndices;    /**< Manager index + 1 per Helper slot, 0 until resolved. */
+            Vector<QueryCache> queryCaches; /**< Cache of each LookupCache slot. */
+            Vector<SparseSet> sparseSets;   /**< Values of each sparse component type, by SparseSlot. */
+            bool hierarchyDirty = false;    /**< Parent links changed since depths were last computed, see World::SetParent(). */
+            size_t hierarchyRows = 0;       /**< Sum of rowsAdded over the archetypes holding ChildOf when depths were last computed. */
+            Vector<Job> jobs;               /**< Jobs of the last dispatch, kept so that dispatches only allocate to grow. */
+            Vector<uint32_t> jobSystems;    /**< Systems of the Schedule stage being dispatched matching each archetype. */
+            Vector<Index> scratch;          /**< Temporary indices of iterations and sorts, nested users stacked at the end. */
+#if SECS_ENABLE_STATS
+            StorageStats stats;             /**< Activity of the archetypes, see World::GetStats(). */
+#endif
+        };
+
+        static Storage defaultStorage;                      /**< Archetypes of the default world. */
+        static SECS_THREAD_LOCAL Storage* storage;          /**< Archetypes of the world current on this thread. */
+
+        // Slots are handed out to every instantiated Helper and LookupCache during static initialization
+        static inline size_t helperSlots = 0;
+        static inline size_t cacheSlots = 0;
+        static inline size_t sparseSlots = 0;
 
-        static inline std::vector<ArchetypeManager> managers;
+        static inline constexpr size_t ChangeBlockShift = std::countr_zero(size_t(SECS_CHANGE_BLOCK_ROWS));
+        static inline constexpr size_t LookupMask = SECS_ARCHETYPE_LOOKUP_SIZE - 1;
+
+        /**
+         * @brief Get an archetype manager of the current world by index.
+         * @param index The index of the archetype manager.
+         * @return A reference to the archetype manager.
+         */
+        static ArchetypeManager& Get(size_t index) { return storage->managers[index]; }
+
+        /**
+         * @brief Get the query cache of a LookupCache slot in the current world.
+         * @details The cache table is sized for every slot at once, so that references to caches stay valid
+         * while other queries update theirs.
+         * @param slot The slot of the LookupCache.
+         * @return A reference to the cache.
+         */
+        static QueryCache& Cache(size_t slot)
+        {
+            Vector<QueryCache>& caches = storage->queryCaches;
+            if (caches.size() < cacheSlots) { caches.resize(cacheSlots); }
+            return caches[slot];
+        }
+
+        /**
+         * @brief Compute the first lookup table slot for a component binary identifier.
+         * @details Uses Fibonacci hashing so that identifiers differing only in low bits spread over the table.
+         * @param id The binary identifier of the components.
+         * @return The slot index.
+         */
+        static size_t Hash(Component::BinaryId id)
+        {
+            const Component::BinaryId::Word folded = id.Fold();
+            if constexpr (sizeof(folded) > 4)
+            {
+                return static_cast<size_t>((static_cast<uint64_t>(folded) * 11400714819323198485ull) >> 32) & LookupMask;
+            }
+            else
+            {
+                return static_cast<size_t>((static_cast<uint32_t>(folded) * 2654435769u) >> 16) & LookupMask;
+            }
+        }
 
         /**
          * @brief Finds the index of the archetype manager associated with a specific component binary identifier.
+         * @details The archetype is created if it does not exist yet.
          * @param id The binary identifier of the components.
          * @return The index of the archetype manager.
          */
         static size_t Find(Component::BinaryId id)
         {
-            size_t size = managers.size();
+            Vector<ArchetypeManager>& managers = storage->managers;
+            Index* lookupTable = storage->lookupTable;
+            size_t slot = Hash(id);
+
+            for (size_t probe = 0; probe < SECS_ARCHETYPE_LOOKUP_SIZE; ++probe)
+            {
+                Index entry = lookupTable[slot];
+                if (entry == 0)
+                {
+                    size_t index = managers.size();
+                    managers.push_back(std::move(ArchetypeManager(id)));
+                    lookupTable[slot] = static_cast<Index>(index + 1);
+                    return index;
+                }
+
+                if (managers[entry - 1].id == id) { return entry - 1; }
+                slot = (slot + 1) & LookupMask;
+            }
 
-            for (size_t i = 0; i < size; ++i)
+            // The table is full, it holds the first SECS_ARCHETYPE_LOOKUP_SIZE archetypes
+            size_t size = managers.size();
+            for (size_t i = SECS_ARCHETYPE_LOOKUP_SIZE; i < size; ++i)
             {
                 if (managers[i].id == id) { return i; }
             }
@@ -188,16 +362,25 @@ namespace SECS
         template <typename... T>
         struct HelperImplementation
         {
+            static_assert((!SparseStorage<T>::value && ...),
+                "Sparse components are not stored in archetypes, see SECS::SparseStorage");
+
             static inline Component::BinaryId id = (Component::IdBinary<T> | ...);
+            static inline const size_t slot = helperSlots++;
 
             /**
-             * @brief Get the instance of the archetype manager.
+             * @brief Get the instance of the archetype manager in the current world.
+             * @details The archetype is looked up once per world, its index is then cached in the world.
              * @return The instance.
              */
             static ArchetypeManager& GetInstance()
             {
-                static const size_t index = ArchetypeManager::Find(id);
-                return ArchetypeManager::managers[index];
+                Vector<Index>& indices = storage->helperIndices;
+                if (indices.size() < helperSlots) { indices.resize(helperSlots, 0); }
+
+                Index& index = indices[slot];
+                if (!index) { index = static_cast<Index>(Find(id) + 1); }
+                return storage->managers[index - 1];
             }
 
             /**
@@ -223,272 +406,1579 @@ namespace SECS
 
         /**
          * @brief Template alias for HelperImplementation.
+         * @details Const qualifiers are dropped, so read-only access maps to the same components.
          * @tparam Ts The component types.
          */
         template <class... Ts>
-        using Helper = Instantiate<HelperImplementation, SortedList<list<Ts...>>>;
+        using Helper = Instantiate<HelperImplementation, SortedList<list<std::remove_cv_t<Ts>...>>>;
+
+        /**
+         * @brief Get the address identifying where the storage of the archetype lives.
+         * @return The address of the first storage block, or nullptr if nothing is allocated.
+         */
+        const void* StorageAddress() const
+        {
+#if SECS_CHUNK_SIZE
+            return chunks ? chunks[0] : nullptr;
+#else
+            return recordIndices;
+#endif
+        }
+
+        /**
+         * @brief Get the bytes taken by one row of the archetype.
+         * @return The size of one element of every column plus the record index.
+         */
+        size_t RowBytes() const
+        {
+            size_t bytes = sizeof(Index);
+            for (InternalIndex column = 0; column < columnCount; ++column)
+            {
+                bytes += columns[column].size;
+            }
+            return bytes;
+        }
 
         /**
          * @brief Struct for caching lookup results.
+         * @details Besides every matched archetype, the cache keeps the view of the matched archetypes
+         * that currently hold entities. The view is rebuilt, and sorted according to
+         * SECS_ARCHETYPE_ORDER, only when an archetype crossed zero entities or moved its storage.
+         * @tparam Filter The QueryFilter refining the matched archetypes.
          * @tparam T The component types.
          */
-        template <typename... T>
+        template <typename Filter, typename... T>
         struct LookupCacheImplementation
         {
-            static inline size_t lastIndexChecked = 0;
-            static inline std::vector<uint16_t> matchedIndices;
+            static inline const size_t slot = cacheSlots++;
 
             /**
-             * @brief Update the cache.
+             * @brief Update the cache of the current world.
+             * @return The matched archetypes holding entities.
              */
-            static void Update()
+            static const Vector<Index>& Update()
             {
-                if (lastIndexChecked < ArchetypeManager::managers.size())
+                QueryCache& cache = Cache(slot);
+                const Vector<ArchetypeManager>& managers = storage->managers;
+                const size_t matchedCount = cache.matchedIndices.size();
+                if (cache.lastIndexChecked < managers.size())
                 {
-                    auto cacheIterator = ArchetypeManager::managers.begin() + lastIndexChecked;
-                    while (cacheIterator != ArchetypeManager::managers.end())
+                    // The masks are resolved once, each archetype then costs two word-wise tests
+                    const Component::BinaryId required = Filter::Required(ColumnsId<T...>());
+                    const Component::BinaryId excluded = Filter::WithoutId();
+
+                    for (; cache.lastIndexChecked < managers.size(); ++cache.lastIndexChecked)
                     {
-                        ArchetypeManager& manager = *cacheIterator;
-                        if (manager.Contains(Helper<T...>::id))
+                        const ArchetypeManager& manager = managers[cache.lastIndexChecked];
+                        if (manager.id.Contains(required) && !manager.id.Intersects(excluded))
                         {
-                            matchedIndices.push_back(lastIndexChecked);
+                            cache.matchedIndices.push_back(static_cast<Index>(cache.lastIndexChecked));
                         }
-                        ++cacheIterator;
-                        ++lastIndexChecked;
                     }
                 }
+
+                if (matchedCount != cache.matchedIndices.size() || cache.activeEpoch != storage->occupancyEpoch)
+                {
+                    cache.activeEpoch = storage->occupancyEpoch;
+                    cache.activeIndices.clear();
+                    for (Index index : cache.matchedIndices)
+                    {
+                        if (managers[index].size) { cache.activeIndices.push_back(index); }
+                    }
+
+#if SECS_ARCHETYPE_ORDER == SECS_ORDER_SIZE
+                    std::sort(cache.activeIndices.begin(), cache.activeIndices.end(), [&managers](Index a, Index b)
+                    {
+                        return managers[a].size > managers[b].size;
+                    });
+#elif SECS_ARCHETYPE_ORDER == SECS_ORDER_ADDRESS
+                    std::sort(cache.activeIndices.begin(), cache.activeIndices.end(), [&managers](Index a, Index b)
+                    {
+                        return reinterpret_cast<uintptr_t>(managers[a].StorageAddress()) <
+                            reinterpret_cast<uintptr_t>(managers[b].StorageAddress());
+                    });
+#endif
+                }
+
+                return cache.activeIndices;
+            }
+
+            /**
+             * @brief Count one run of the query in the current world, see QueryStats.
+             * @details Update() only resolves archetypes, the iterations count their own runs.
+             */
+            static void CountIteration()
+            {
+#if SECS_ENABLE_STATS
+                QueryCache& cache = Cache(slot);
+                cache.stats.iterations++;
+                cache.stats.archetypesSkipped += cache.matchedIndices.size() - cache.activeIndices.size();
+#endif
+            }
+
+            /**
+             * @brief Count rows handed to the lambda of the query in the current world, see QueryStats.
+             * @param rows The number of rows.
+             */
+            static void CountVisited(size_t rows)
+            {
+#if SECS_ENABLE_STATS
+                Cache(slot).stats.rowsVisited += rows;
+#else
+                (void)rows;
+#endif
             }
         };
 
+        /**
+         * @brief Template alias for LookupCacheImplementation refined by query filters.
+         * @details Const qualifiers are dropped, so read-only access maps to the same components.
+         * @tparam Filter The QueryFilter refining the matched archetypes.
+         * @tparam Ts The component types.
+         */
+        template <class Filter, class... Ts>
+        using FilteredLookupCache = Instantiate<LookupCacheImplementation,
+            Concat<list<Filter>, SortedList<list<std::remove_cv_t<Ts>...>>>>;
+
         /**
          * @brief Template alias for LookupCacheImplementation.
+         * @details Const qualifiers are dropped, so read-only access maps to the same components.
          * @tparam Ts The component types.
          */
         template <class... Ts>
-        using LookupCache = Instantiate<LookupCacheImplementation, SortedList<list<Ts...>>>;
+        using LookupCache = FilteredLookupCache<QueryFilter<>, Ts...>;
 
-        Index GetIndex() { return static_cast<Index>(this - &(*managers.begin())); }
+        /**
+         * @brief Check at compile time whether a component type is kept in a sparse set.
+         * @tparam T The component type, cv qualifiers are ignored.
+         */
+        template <typename T>
+        static inline constexpr bool IsSparse = SparseStorage<std::remove_cv_t<T>>::value;
 
-        Component::BinaryId id;
+        /**
+         * @brief Check at compile time whether any of a set of component types is kept in a sparse set.
+         * @tparam Ts The component types.
+         */
+        template <typename... Ts>
+        static inline constexpr bool HasSparse = (false || ... || IsSparse<Ts>);
 
-        using InternalIndex = uint8_t;
-        static inline constexpr InternalIndex Unused = ~(InternalIndex(0));
+        /**
+         * @brief Slot of a sparse component type in the sparse set table of every world.
+         * @tparam T The component type.
+         */
+        template <typename T>
+        struct SparseSlot
+        {
+            static_assert(!TrackChanges<T>::value, "Sparse components do not support change detection");
 
-        Index* recordIndices = nullptr;
-        void** componentArrays = nullptr;
-        InternalIndex internalIndex[Component::MaxComponentTypes] = { Unused };
-        Index capacity = 0;
-        Index size = 0;
+            static inline const size_t slot = sparseSlots++;
+        };
 
         /**
-         * @brief Iterate over each component in a binary identifier.
-         * @param id The binary identifier.
-         * @param lambda The lambda function to apply to each component.
+         * @brief Get the sparse set of a component type in the current world.
+         * @details The set table is sized for every slot at once, so that references to sets stay valid.
+         * @tparam T The component type, cv qualifiers are ignored.
+         * @return A reference to the sparse set.
          */
-        template <typename Lambda>
-        static void EachComponent(Component::BinaryId id, Lambda lambda)
+        template <typename T>
+        static SparseSet& Sparse()
         {
-            size_t componentId = 0;
-            do
-            {
-                if (1 & id) { lambda(componentId); }
-                componentId++;
-            } while (id >>= 1);
+            using Type = std::remove_cv_t<T>;
+            Vector<SparseSet>& sets = storage->sparseSets;
+            if (sets.size() < sparseSlots) { sets.resize(sparseSlots); }
+
+            SparseSet& set = sets[SparseSlot<Type>::slot];
+            if (!set.ops) { set.ops = &SparseSet::OperationsOf<Type>; }
+            return set;
         }
 
         /**
-         * @brief Iterate over common components in two binary identifiers.
-         * @param idA The first binary identifier.
-         * @param idB The second binary identifier.
-         * @param lambda The lambda function to apply to common components.
+         * @brief Get the archetype components among a set of component types.
+         * @tparam Ts The component types, sparse ones are skipped.
+         * @return The binary identifier of the components stored in archetypes.
          */
-        template <typename Lambda>
-        static void EachCommonComponent(Component::BinaryId idA, Component::BinaryId idB, Lambda lambda)
+        template <typename... Ts>
+        static Component::BinaryId ColumnsId()
         {
-            size_t componentId = 0;
-            do
+            if constexpr (!HasSparse<Ts...>)
+            {
+                return Helper<Ts...>::id;
+            }
+            else
             {
-                if (1 & idA & idB) { lambda(componentId); }
-                componentId++;
-            } while ((idA >>= 1) && (idB >>= 1));
+                return (Component::BinaryId() | ... | ColumnIdOf<Ts>());
+            }
         }
 
         /**
-         * @brief Check if the archetype contains a set of components.
-         * @param expected The binary identifier of expected components.
-         * @return true if the archetype contains the expected components, false otherwise.
+         * @brief Get the binary identifier of one component type, or an empty one if it is sparse.
+         * @tparam T The component type.
          */
-        bool Contains(Component::BinaryId expected) { return (id & expected) == expected; }
+        template <typename T>
+        static Component::BinaryId ColumnIdOf()
+        {
+            if constexpr (IsSparse<T>)
+            {
+                return Component::BinaryId();
+            }
+            else
+            {
+                return Helper<T>::id;
+            }
+        }
 
         /**
-         * @brief Get a strongly-typed pointer to a component array.
+         * @brief Get a sparse component of an entity.
          * @tparam T The component type.
-         * @return A pointer to the component array.
+         * @param record The entity record index.
+         * @return A pointer to the component, or nullptr if the entity lacks it. For tags the
+         *         pointer refers to one instance shared by every entity.
          */
         template <typename T>
-        T* GetComponentArray() const
+        static T* GetSparse(Index record)
         {
-            return static_cast<T*>(componentArrays[internalIndex[Component::Id<T>]]);
+            using Type = std::remove_cv_t<T>;
+            const SparseSet& set = Sparse<Type>();
+            const Index dense = set.Find(record);
+            if (dense == InvalidIndex) { return nullptr; }
+
+            if constexpr (std::is_empty_v<Type>)
+            {
+                static Type instance;
+                return &instance;
+            }
+            else
+            {
+                return static_cast<T*>(set.Value(dense));
+            }
         }
 
         /**
-         * @brief Get a strongly-typed pointer to a component within a row.
+         * @brief Get a component of an entity, wherever it is stored.
          * @tparam T The component type.
-         * @param row The row index.
-         * @return A pointer to the component.
+         * @param manager The archetype of the entity.
+         * @param record The EntityRecord of the entity.
+         * @return A pointer to the component, or nullptr if the entity lacks it.
          */
         template <typename T>
-        T* GetComponent(Index row) const
+        static T* Fetch(const ArchetypeManager& manager, const EntityRecord& record)
         {
-            auto index = internalIndex[Component::Id<T>];
-            return (index == Unused) ? nullptr :
-                &((static_cast<T*>(componentArrays[index]))[row]);
+            if constexpr (IsSparse<T>)
+            {
+                return GetSparse<T>(record.GetIndex());
+            }
+            else
+            {
+                return manager.GetComponent<T>(record.row);
+            }
         }
 
-    public:
         /**
-         * @brief Default constructor.
+         * @brief Create the sparse set of a component type in the current world if it is sparse.
+         * @details Sparse() creates sets on first use; creating them up front leaves the workers
+         * of a dispatch only reading the set table.
+         * @tparam T The component type.
          */
-        ArchetypeManager() = default;
+        template <typename T>
+        static void PrepareSparse()
+        {
+            if constexpr (IsSparse<T>) { Sparse<T>(); }
+        }
 
         /**
-         * @brief Move constructor.
-         * @param other The other ArchetypeManager to move.
+         * @brief Check whether an entity holds a component if it is sparse.
+         * @tparam T The component type.
+         * @param record The entity record index.
+         * @return False only for sparse components the entity lacks.
          */
-        ArchetypeManager(ArchetypeManager&& other) noexcept
-            : id(std::move(other.id)),
-            recordIndices(std::move(other.recordIndices)),
-            componentArrays(std::move(other.componentArrays)),
-            capacity(std::move(other.capacity)),
-            size(std::move(other.size))
+        template <typename T>
+        static bool HoldsSparse(Index record)
         {
-            for (size_t i = 0; i < Component::MaxComponentTypes; ++i)
+            if constexpr (IsSparse<T>)
             {
-                internalIndex[i] = std::move(other.internalIndex[i]);
-                other.internalIndex[i] = Unused;
+                return Sparse<T>().Find(record) != InvalidIndex;
+            }
+            else
+            {
+                (void)record;
+                return true;
             }
-
-            // Reset the source object
-            other.id = 0;
-            other.recordIndices = nullptr;
-            other.componentArrays = nullptr;
-            other.capacity = 0;
-            other.size = 0;
         }
 
         /**
-         * @brief Move assignment operator.
-         * @param other The other ArchetypeManager to move.
-         * @return Reference to this ArchetypeManager after the move.
+         * @brief Check whether an entity lacks a component if it is sparse.
+         * @tparam T The component type.
+         * @param record The entity record index.
+         * @return False only for sparse components the entity holds.
          */
-        ArchetypeManager& operator=(ArchetypeManager&& other) noexcept
+        template <typename T>
+        static bool LacksSparse(Index record)
         {
-            if (this != &other)
+            if constexpr (IsSparse<T>)
             {
-                id = std::move(other.id);
-                recordIndices = std::move(other.recordIndices);
-                componentArrays = std::move(other.componentArrays);
-                capacity = std::move(other.capacity);
-                size = std::move(other.size);
-
-                for (size_t i = 0; i < Component::MaxComponentTypes; ++i)
-                {
-                    internalIndex[i] = std::move(other.internalIndex[i]);
-                    other.internalIndex[i] = Unused;
-                }
-
-                // Reset the source object
-                other.id = 0;
-                other.recordIndices = nullptr;
-                other.componentArrays = nullptr;
-                other.capacity = 0;
-                other.size = 0;
+                return Sparse<T>().Find(record) == InvalidIndex;
+            }
+            else
+            {
+                (void)record;
+                return true;
             }
-
-            return *this;
         }
 
-    private:
         /**
-         * @brief Construct an ArchetypeManager with a given binary identifier.
-         * @param newId The binary identifier.
+         * @brief Make sure adding a component to an entity cannot fail, if it is sparse.
+         * @tparam T The component type.
+         * @param record The entity record index.
+         * @return False only if the storage of a sparse component could not be allocated.
          */
-        ArchetypeManager(Component::BinaryId newId) : id(newId)
+        template <typename T>
+        static bool ReserveSparse(Index record)
         {
-            uint8_t localComponentCount = 0;
-            EachComponent(newId, [this, &localComponentCount](size_t componentId)
+            if constexpr (IsSparse<T>)
             {
-                internalIndex[componentId] = localComponentCount++;
-            });
+                return Sparse<T>().Reserve(record);
+            }
+            else
+            {
+                (void)record;
+                return true;
+            }
+        }
 
-            componentArrays = new void* [localComponentCount]();
+        /**
+         * @brief Add a value initialized component to an entity if it is sparse, ReserveSparse() must have succeeded.
+         * @tparam T The component type.
+         * @param record The entity record index.
+         */
+        template <typename T>
+        static void InsertSparse(Index record)
+        {
+            if constexpr (IsSparse<T>) { Sparse<T>().Insert(record); }
+            else { (void)record; }
         }
 
         /**
-         * @brief Reserve an EntityRecord within the archetype.
-         * @return The reserved EntityRecord.
+         * @brief Remove a component from an entity if it is sparse.
+         * @tparam T The component type.
+         * @param record The entity record index.
          */
-        EntityRecord& ReserveRecord()
+        template <typename T>
+        static void EraseSparse(Index record)
         {
-            EntityRecord& entityRecord = EntityRecord::Reserve();
+            if constexpr (IsSparse<T>) { Sparse<T>().Erase(record); }
+            else { (void)record; }
+        }
 
-            if (size >= capacity)
-            {
-                capacity = (capacity == 0) ? 2 : (capacity * 2) - (capacity / 2);
-                recordIndices = static_cast<Index*>(realloc(recordIndices, sizeof(Index) * capacity));
+        /**
+         * @brief Get the smallest sparse set among a set of component types.
+         * @tparam Ts The component types, at least one of them sparse.
+         * @return A pointer to the sparse set holding the fewest entities.
+         */
+        template <typename... Ts>
+        static const SparseSet* SmallestSparse()
+        {
+            const SparseSet* smallest = nullptr;
+            (KeepSmallerSparse<Ts>(smallest), ...);
+            return smallest;
+        }
 
-                EachComponent(id, [this](const size_t& componentId)
-                {
-                    Component::ResizeArray(componentId, &componentArrays[internalIndex[componentId]], capacity, size);
-                });
+        /**
+         * @brief Replace a sparse set by the one of a component type if it is sparse and smaller.
+         * @tparam T The component type.
+         * @param smallest The smallest sparse set so far, or nullptr.
+         */
+        template <typename T>
+        static void KeepSmallerSparse(const SparseSet*& smallest)
+        {
+            if constexpr (IsSparse<T>)
+            {
+                const SparseSet& set = Sparse<T>();
+                if (!smallest || set.Size() < smallest->Size()) { smallest = &set; }
+            }
+            else
+            {
+                (void)smallest;
             }
-            recordIndices[size] = entityRecord.GetIndex();
-
-            entityRecord.archetype = static_cast<Index>(GetIndex());
-            entityRecord.row = size++;
-
-            return entityRecord;
         }
 
         /**
-         * @brief Remove a row from the archetype.
-         * @param row The row index to remove.
+         * @brief Remove an entity from every sparse set of the current world.
+         * @param record The entity record index.
          */
-        void RemoveRow(Index row)
+        static void EraseSparse(Index record)
         {
-            if (size) size--;
-            Index lastRow = size;
-            if (row != lastRow)
+            for (SparseSet& set : storage->sparseSets)
             {
-                EachComponent(id, [this, row, lastRow](size_t componentId)
-                {
-                    void* arrayPtr = componentArrays[internalIndex[componentId]];
-                    Component::MoveElement(componentId, arrayPtr, row, arrayPtr, lastRow);
-                });
-
-                EntityRecord::records[recordIndices[row]].Release();
-                EntityRecord::records[recordIndices[lastRow]].row = row;
-                recordIndices[row] = recordIndices[lastRow];
+                if (set.ops) { set.Erase(record); }
             }
         }
 
         /**
-         * @brief Move an entity from another archetype into this archetype.
-         * @param sourceArchetype The source archetype.
-         * @param sourceRow The source row within the source archetype.
-         * @return The EntityRecord for the moved entity.
+         * @brief Cached archetype transition.
+         * @details Maps a set of added or removed components to the archetype reached from this one.
+         */
+        struct Edge
+        {
+            Component::BinaryId delta;  /**< Binary identifier of the components added or removed. */
+            Index target;               /**< Index of the resulting archetype manager. */
+        };
+
+        /**
+         * @brief Resolve the archetype reached by adding or removing components from another archetype.
+         * @details The first transition for a given set of components goes through Find(), the result is
+         * then cached on both archetypes so that repeated toggles only scan the (short) edge lists.
+         * @param source The index of the source archetype manager.
+         * @param delta The binary identifier of the components to add or remove.
+         * @param add true to add the components, false to remove them.
+         * @return The index of the target archetype manager.
          */
-        EntityRecord& MoveEntity(ArchetypeManager* sourceArchetype, size_t sourceRow)
+        static Index Transition(Index source, Component::BinaryId delta, bool add)
         {
-            EntityRecord& record = ReserveRecord();
-            EachCommonComponent(id, sourceArchetype->id, [this, &record, sourceArchetype, sourceRow](size_t componentId)
+            Vector<ArchetypeManager>& managers = storage->managers;
+            const Vector<Edge>& edges = add ? managers[source].addEdges : managers[source].removeEdges;
+            for (const Edge& edge : edges)
             {
-                void* arrayPtr = componentArrays[internalIndex[componentId]];
-                void* srcArrayPtr = sourceArchetype->componentArrays[sourceArchetype->internalIndex[componentId]];
-                Component::MoveElement(componentId, arrayPtr, record.row, srcArrayPtr, sourceRow);
-            });
-            sourceArchetype->RemoveRow(sourceRow);
-            return record;
-        }
-    };
+                if (edge.delta == delta) { return edge.target; }
+            }
+
+            Component::BinaryId sourceId = managers[source].id;
+            Index target = static_cast<Index>(Find(add ? (sourceId | delta) : (sourceId & ~delta)));
+
+            // Find() may have grown managers, so edge lists are fetched again
+            if (target != source)
+            {
+                (add ? managers[source].addEdges : managers[source].removeEdges).push_back(Edge{ delta, target });
+
+                // The reverse transition is only valid when every component in delta actually changed
+                if ((managers[source].id & delta) == (add ? Component::BinaryId() : delta))
+                {
+                    (add ? managers[target].removeEdges : managers[target].addEdges).push_back(Edge{ delta, source });
+                }
+            }
+
+            return target;
+        }
+
+        Index GetIndex() { return static_cast<Index>(this - storage->managers.data()); }
+
+        Component::BinaryId id;
+        Component::BinaryId columnsId;      /**< Components of the archetype that own a column, i.e. id without tags. */
+        Component::BinaryId trivialId;      /**< Columns of trivially copyable components, constructed when rows are reserved. */
+        Component::BinaryId trackedId;      /**< Columns of components opted into change detection. */
+
+        using InternalIndex = std::conditional_t<(Component::MaxComponentTypes < UINT8_MAX), uint8_t, uint16_t>;
+        static inline constexpr InternalIndex Unused = ~(InternalIndex(0));
+
+#if SECS_CHUNK_SIZE
+        uint8_t** chunks = nullptr;         /**< Chunk table, each chunk holds the record indices and every component column for 2^chunkShift rows. */
+        size_t* columnOffsets = nullptr;    /**< Byte offset of each component column within a chunk. */
+        size_t chunkBytes = 0;              /**< Allocation size of one chunk. */
+        uint8_t chunkShift = 0;             /**< Base 2 logarithm of the number of rows per chunk. */
+#else
+        Index* recordIndices = nullptr;
+        void** componentArrays = nullptr;
+#endif
+        /**
+         * @brief Precomputed operations of one component column.
+         * @details Built once per archetype so that row moves run over a packed table instead of
+         * scanning the binary identifier and looking up the operation of each component.
+         */
+        struct ColumnOperation
+        {
+            Component::MoveElementFunction move;    /**< Move operation of the component type. */
+            size_t size;                            /**< Size of one element in bytes. */
+            InternalIndex componentId;              /**< ID of the component type. */
+            bool trivial;                           /**< Elements are moved with memcpy. */
+        };
+
+        ColumnOperation* columns = nullptr;         /**< Operations of each column, indexed by internal index. */
+        InternalIndex columnCount = 0;
+        InternalIndex trackedCount = 0;
+        uint32_t* changeTicks = nullptr;            /**< Last write tick of each tracked column, trackedCount entries per change block. */
+        size_t changeBlocks = 0;                    /**< Number of change blocks changeTicks holds. */
+        Index capacity = 0;
+        Index size = 0;
+        size_t idleFrames = 0;            /**< Consecutive World::AutoCompact() calls that found the archetype empty. */
+        size_t rowEpoch = 0;              /**< Bumped whenever rows leave the archetype or its storage moves, see View. */
+        size_t rowsAdded = 0;             /**< Rows ever added to the archetype, see World::SortHierarchy(). */
+        size_t sortedStamp = 0;           /**< rowEpoch + rowsAdded when World::SortHierarchy() last left the rows sorted, both only grow. */
+        Vector<Edge> addEdges;            /**< Cached transitions for added components. */
+        Vector<Edge> removeEdges;         /**< Cached transitions for removed components. */
+
+        /**
+         * @brief Iterate over each component in a binary identifier.
+         * @param id The binary identifier.
+         * @param lambda The lambda function to apply to each component.
+         */
+        template <typename Lambda>
+        static void EachComponent(Component::BinaryId id, Lambda lambda)
+        {
+            id.ForEach(lambda);
+        }
+
+        /**
+         * @brief Iterate over common components in two binary identifiers.
+         * @param idA The first binary identifier.
+         * @param idB The second binary identifier.
+         * @param lambda The lambda function to apply to common components.
+         */
+        template <typename Lambda>
+        static void EachCommonComponent(Component::BinaryId idA, Component::BinaryId idB, Lambda lambda)
+        {
+            (idA & idB).ForEach(lambda);
+        }
+
+        /**
+         * @brief Check whether structural changes are currently forbidden.
+         * @details While a parallel dispatch is in progress no entity may be created, destroyed
+         * or moved between archetypes, and no archetype may be created.
+         * @return true if the archetype and entity record storage must not change.
+         */
+        static bool IsLocked() { return storage->structuralLocks != 0; }
+
+        /**
+         * @brief Check if the archetype contains a set of components.
+         * @param expected The binary identifier of expected components.
+         * @return true if the archetype contains the expected components, false otherwise.
+         */
+        bool Contains(Component::BinaryId expected) { return id.Contains(expected); }
+
+        /**
+         * @brief Get the column storing a component type.
+         * @details Columns are laid out in increasing component ID order, so the column of a component
+         * is the number of columns of lower component IDs. This replaces a per-archetype table with one
+         * entry per possible component type.
+         * @param componentId The ID of the component type.
+         * @return The internal index of the column, or Unused if the archetype has no column for it.
+         */
+        InternalIndex ColumnIndex(size_t componentId) const
+        {
+            return columnsId.Test(componentId) ? static_cast<InternalIndex>(columnsId.Rank(componentId)) : Unused;
+        }
+
+        /**
+         * @brief Get the base of the component column storing a row.
+         * @details With chunked storage this is the column inside the chunk holding the row, otherwise it is
+         * the whole column. The row is found at ColumnPosition(row) from that base.
+         * @param column The internal index of the component column.
+         * @param row The row index.
+         * @return A pointer to the column base.
+         */
+        void* GetColumn(InternalIndex column, Index row) const
+        {
+#if SECS_CHUNK_SIZE
+            return chunks[row >> chunkShift] + columnOffsets[column];
+#else
+            (void)row;
+            return componentArrays[column];
+#endif
+        }
+
+        /**
+         * @brief Get the position of a row relative to the column base returned by GetColumn().
+         * @param row The row index.
+         * @return The position of the row within its column.
+         */
+        Index ColumnPosition(Index row) const
+        {
+#if SECS_CHUNK_SIZE
+            return row & ((Index(1) << chunkShift) - 1);
+#else
+            return row;
+#endif
+        }
+
+        /**
+         * @brief Get the index of the EntityRecord stored in a row.
+         * @param row The row index.
+         * @return A reference to the record index.
+         */
+        Index& RecordIndex(Index row)
+        {
+#if SECS_CHUNK_SIZE
+            return reinterpret_cast<Index*>(chunks[row >> chunkShift])[ColumnPosition(row)];
+#else
+            return recordIndices[row];
+#endif
+        }
+
+        /**
+         * @brief Iterate over the ranges of rows that are contiguous in memory within a row range.
+         * @details With chunked storage the range is split at chunk boundaries, otherwise it forms a single span.
+         * Within a span, component pointers for consecutive rows are consecutive.
+         * @param begin The first row of the range.
+         * @param end One past the last row of the range.
+         * @param lambda The lambda function called with the first row and the row count of each span.
+         */
+        template <typename Lambda>
+        void EachSpan(Index begin, Index end, Lambda lambda) const
+        {
+#if SECS_CHUNK_SIZE
+            const size_t rowsPerChunk = size_t(1) << chunkShift;
+            for (size_t first = begin; first < end;)
+            {
+                size_t chunkEnd = (first & ~(rowsPerChunk - 1)) + rowsPerChunk;
+                size_t last = (chunkEnd < end) ? chunkEnd : end;
+                lambda(static_cast<Index>(first), static_cast<Index>(last - first));
+                first = last;
+            }
+#else
+            if (begin < end) { lambda(begin, static_cast<Index>(end - begin)); }
+#endif
+        }
+
+        /**
+         * @brief Iterate over the ranges of rows that are contiguous in memory.
+         * @details With chunked storage every chunk forms one span, otherwise all rows form a single span.
+         * @param lambda The lambda function called with the first row and the row count of each span.
+         */
+        template <typename Lambda>
+        void EachSpan(Lambda lambda) const
+        {
+            EachSpan(0, size, lambda);
+        }
+
+        /**
+         * @brief Iterate over the change blocks within a row range.
+         * @details Like EachSpan(), except that spans are also split at change block boundaries, so every
+         * call covers rows sharing one change tick.
+         * @param begin The first row of the range.
+         * @param end One past the last row of the range.
+         * @param lambda The lambda function called with the first row and the row count of each block.
+         */
+        template <typename Lambda>
+        void EachChangeBlock(Index begin, Index end, Lambda lambda) const
+        {
+            EachSpan(begin, end, [&lambda](Index first, Index count)
+            {
+                constexpr size_t blockRows = size_t(1) << ChangeBlockShift;
+                const size_t spanEnd = size_t(first) + count;
+                for (size_t blockFirst = first; blockFirst < spanEnd;)
+                {
+                    size_t blockEnd = (blockFirst & ~(blockRows - 1)) + blockRows;
+                    blockEnd = (blockEnd < spanEnd) ? blockEnd : spanEnd;
+                    lambda(static_cast<Index>(blockFirst), static_cast<Index>(blockEnd - blockFirst));
+                    blockFirst = blockEnd;
+                }
+            });
+        }
+
+        /**
+         * @brief Stamp the change blocks of a row range with the current change tick.
+         * @param first The first row of the range.
+         * @param count The number of rows.
+         * @param components The binary identifier of the written components, untracked ones are ignored.
+         */
+        void MarkChanged(Index first, Index count, Component::BinaryId components)
+        {
+            components &= trackedId;
+            if (!components || !count) { return; }
+
+            const size_t firstBlock = size_t(first) >> ChangeBlockShift;
+            const size_t lastBlock = (size_t(first) + count - 1) >> ChangeBlockShift;
+            const uint32_t tick = storage->changeTick;
+            components.ForEach([this, firstBlock, lastBlock, tick](size_t componentId)
+            {
+                const size_t tracked = trackedId.Rank(componentId);
+                for (size_t block = firstBlock; block <= lastBlock; ++block)
+                {
+                    changeTicks[block * trackedCount + tracked] = tick;
+                }
+            });
+        }
+
+        /**
+         * @brief Check whether components of the change block holding a row were written after a given tick.
+         * @param row The row index.
+         * @param components The binary identifier of the components to check, untracked ones are ignored.
+         * @param tick The tick to compare against.
+         * @return true if any of the tracked components was written in the block after tick.
+         */
+        bool ChangedSince(Index row, Component::BinaryId components, uint32_t tick) const
+        {
+            const uint32_t* blockTicks = changeTicks + (size_t(row) >> ChangeBlockShift) * trackedCount;
+            bool changed = false;
+            (components & trackedId).ForEach([this, blockTicks, tick, &changed](size_t componentId)
+            {
+                changed = changed || blockTicks[trackedId.Rank(componentId)] > tick;
+            });
+            return changed;
+        }
+
+        /**
+         * @brief Get the tracked components written through a set of lambda parameters.
+         * @tparam Components The component types of the lambda parameters, const ones are only read.
+         * @return The binary identifier of the non-const components opted into change detection.
+         */
+        template <typename... Components>
+        static Component::BinaryId WrittenId()
+        {
+            return (Component::BinaryId() | ... | WrittenIdOf<Components>());
+        }
+
+        /**
+         * @brief Get the tracked component written through one lambda parameter.
+         * @tparam T The component type of the parameter.
+         * @return Its binary identifier if it is non-const and opted into change detection, an empty one otherwise.
+         */
+        template <typename T>
+        static Component::BinaryId WrittenIdOf()
+        {
+            if constexpr (!std::is_const_v<T> && TrackChanges<std::remove_cv_t<T>>::value)
+            {
+                return Helper<T>::id;
+            }
+            else
+            {
+                return Component::BinaryId();
+            }
+        }
+
+        /**
+         * @brief Check at compile time whether lambda parameters write to tracked components.
+         * @tparam Components The component types of the lambda parameters.
+         */
+        template <typename... Components>
+        static inline constexpr bool WritesTracked =
+            (false || ... || (!std::is_const_v<Components> && TrackChanges<std::remove_cv_t<Components>>::value));
+
+        /**
+         * @brief Grow the change tick table so that it covers a given number of rows.
+         * @param newCapacity The number of rows the table must cover.
+         * @return true on success, false if storage could not be allocated.
+         */
+        bool GrowChangeTicks(size_t newCapacity)
+        {
+            const size_t newBlocks = (newCapacity + (size_t(1) << ChangeBlockShift) - 1) >> ChangeBlockShift;
+            if (!trackedCount || newBlocks <= changeBlocks) { return true; }
+
+            uint32_t* newTicks = Memory::Reallocate(changeTicks, changeBlocks * trackedCount, newBlocks * trackedCount);
+            if (!newTicks) { return false; }
+
+            memset(newTicks + changeBlocks * trackedCount, 0, sizeof(uint32_t) * (newBlocks - changeBlocks) * trackedCount);
+            changeTicks = newTicks;
+            changeBlocks = newBlocks;
+            return true;
+        }
+
+        /**
+         * @brief Shrink the change tick table to the blocks covering a given number of rows.
+         * @details The table is kept as is if the smaller one cannot be allocated.
+         * @param newCapacity The number of rows the table must cover.
+         */
+        void ShrinkChangeTicks(size_t newCapacity)
+        {
+            const size_t newBlocks = (newCapacity + (size_t(1) << ChangeBlockShift) - 1) >> ChangeBlockShift;
+            if (!trackedCount || newBlocks >= changeBlocks) { return; }
+
+            uint32_t* newTicks = nullptr;
+            if (newBlocks)
+            {
+                newTicks = Memory::Reallocate(changeTicks, changeBlocks * trackedCount, newBlocks * trackedCount);
+                if (!newTicks) { return; }
+            }
+            else
+            {
+                Memory::Deallocate(changeTicks, changeBlocks * trackedCount);
+            }
+
+            changeTicks = newTicks;
+            changeBlocks = newBlocks;
+        }
+
+        /**
+         * @brief Get a strongly-typed pointer to a component within a row.
+         * @tparam T The component type.
+         * @param row The row index.
+         * @return A pointer to the component, or nullptr if the archetype lacks it. For tags the
+         *         pointer refers to one instance shared by every entity.
+         */
+        template <typename T>
+        T* GetComponent(Index row) const
+        {
+            using Type = std::remove_cv_t<T>;
+            if constexpr (std::is_empty_v<Type>)
+            {
+                // Tags have no column, every entity shares the same instance
+                static Type instance;
+                return (id & Component::IdBinary<Type>) ? &instance : nullptr;
+            }
+            else
+            {
+                auto index = ColumnIndex(Component::Id<Type>);
+                return (index == Unused) ? nullptr :
+                    static_cast<T*>(GetColumn(index, row)) + ColumnPosition(row);
+            }
+        }
+
+    public:
+        /**
+         * @brief Default constructor.
+         */
+        ArchetypeManager() = default;
+
+        /**
+         * @brief Move constructor.
+         * @param other The other ArchetypeManager to move.
+         */
+        ArchetypeManager(ArchetypeManager&& other) noexcept : ArchetypeManager()
+        {
+            *this = std::move(other);
+        }
+
+        /**
+         * @brief Move assignment operator.
+         * @param other The other ArchetypeManager to move.
+         * @return Reference to this ArchetypeManager after the move.
+         */
+        ArchetypeManager& operator=(ArchetypeManager&& other) noexcept
+        {
+            if (this != &other)
+            {
+                id = std::move(other.id);
+                columnsId = std::move(other.columnsId);
+                trivialId = std::move(other.trivialId);
+                trackedId = std::move(other.trackedId);
+                columns = std::move(other.columns);
+                columnCount = std::move(other.columnCount);
+                trackedCount = std::move(other.trackedCount);
+                changeTicks = std::move(other.changeTicks);
+                changeBlocks = std::move(other.changeBlocks);
+#if SECS_CHUNK_SIZE
+                chunks = std::move(other.chunks);
+                columnOffsets = std::move(other.columnOffsets);
+                chunkBytes = std::move(other.chunkBytes);
+                chunkShift = std::move(other.chunkShift);
+#else
+                recordIndices = std::move(other.recordIndices);
+                componentArrays = std::move(other.componentArrays);
+#endif
+                capacity = std::move(other.capacity);
+                size = std::move(other.size);
+                idleFrames = std::move(other.idleFrames);
+                rowEpoch = std::move(other.rowEpoch);
+                rowsAdded = std::move(other.rowsAdded);
+                sortedStamp = std::move(other.sortedStamp);
+                addEdges = std::move(other.addEdges);
+                removeEdges = std::move(other.removeEdges);
+
+                // Reset the source object
+                other.id = {};
+                other.columnsId = {};
+                other.trivialId = {};
+                other.trackedId = {};
+                other.columns = nullptr;
+                other.columnCount = 0;
+                other.trackedCount = 0;
+                other.changeTicks = nullptr;
+                other.changeBlocks = 0;
+#if SECS_CHUNK_SIZE
+                other.chunks = nullptr;
+                other.columnOffsets = nullptr;
+                other.chunkBytes = 0;
+                other.chunkShift = 0;
+#else
+                other.recordIndices = nullptr;
+                other.componentArrays = nullptr;
+#endif
+                other.capacity = 0;
+                other.size = 0;
+                other.idleFrames = 0;
+                other.rowEpoch = 0;
+                other.rowsAdded = 0;
+                other.sortedStamp = 0;
+            }
+
+            return *this;
+        }
+
+    private:
+        /**
+         * @brief Construct an ArchetypeManager with a given binary identifier.
+         * @param newId The binary identifier.
+         */
+        ArchetypeManager(Component::BinaryId newId) : ArchetypeManager()
+        {
+            id = newId;
+            columnsId = newId & ~Component::TagMask;
+            trackedId = columnsId & Component::TrackedMask;
+            trackedCount = static_cast<InternalIndex>(trackedId.Count());
+            const size_t localComponentCount = columnsId.Count();
+            EachComponent(columnsId, [this](size_t componentId)
+            {
+                trivialId |= Component::IsTrivial(componentId) ? Component::BinaryId::Bit(componentId) : Component::BinaryId();
+            });
+
+            // Storage tables are only allocated once the column table exists, so Grow() fails without it
+            columns = Memory::Allocate<ColumnOperation>(localComponentCount + 1);
+            if (!columns) { return; }
+
+            // Columns follow component ID order, see ColumnIndex()
+            EachComponent(columnsId, [this](size_t componentId)
+            {
+                columns[columnCount++] = ColumnOperation{ Component::MoveFunction(componentId),
+                    Component::Size(componentId), static_cast<InternalIndex>(componentId), Component::IsTrivial(componentId) };
+            });
+
+#if SECS_CHUNK_SIZE
+            // One extra entry so that archetypes without components still get a valid table
+            columnOffsets = Memory::Allocate<size_t>(localComponentCount + 1);
+            if (!columnOffsets) { return; }
+
+            // Pick the largest power-of-two row count whose columns still fit in one chunk
+            constexpr uint8_t maxShift = sizeof(Index) * CHAR_BIT - 1;
+            while (chunkShift < maxShift && ChunkLayout(size_t(2) << chunkShift) <= SECS_CHUNK_SIZE)
+            {
+                chunkShift++;
+            }
+
+            chunkBytes = ChunkLayout(size_t(1) << chunkShift);
+#else
+            // One extra entry so that archetypes without components still get a valid table
+            componentArrays = Memory::Allocate<void*>(localComponentCount + 1);
+            if (!componentArrays) { return; }
+
+            for (size_t i = 0; i <= localComponentCount; ++i)
+            {
+                componentArrays[i] = nullptr;
+            }
+#endif
+        }
+
+#if SECS_CHUNK_SIZE
+        /**
+         * @brief Compute the layout of a chunk holding a given number of rows.
+         * @details The record indices come first, followed by each component column aligned for its type.
+         * The column offsets are stored in columnOffsets.
+         * @param rows The number of rows per chunk.
+         * @return The number of bytes needed by one chunk.
+         */
+        size_t ChunkLayout(size_t rows)
+        {
+            size_t bytes = sizeof(Index) * rows;
+            for (InternalIndex column = 0; column < columnCount; ++column)
+            {
+                const size_t componentId = columns[column].componentId;
+                size_t alignment = Component::Alignment(componentId);
+                bytes = (bytes + alignment - 1) & ~(alignment - 1);
+                columnOffsets[column] = bytes;
+                bytes += Component::Size(componentId) * rows;
+            }
+            return bytes;
+        }
+#endif
+
+#if !SECS_CHUNK_SIZE
+        /**
+         * @brief Move the rows into newly allocated storage of a given capacity.
+         * @details All new storage is allocated before anything is moved, so on failure the
+         * archetype is left untouched.
+         * @param newCapacity The number of rows of the new storage, not lower than size and not 0.
+         * @return true on success, false if storage could not be allocated.
+         */
+        bool MoveStorage(Index newCapacity)
+        {
+            void* newArrays[Component::MaxComponentTypes];
+            Index* newRecordIndices = Memory::Allocate<Index>(newCapacity);
+            bool allocated = newRecordIndices != nullptr;
+
+            for (InternalIndex column = 0; column < columnCount; ++column)
+            {
+                void* newArray = allocated ? Component::AllocateArray(columns[column].componentId, newCapacity) : nullptr;
+                allocated = allocated && newArray;
+                newArrays[column] = newArray;
+            }
+
+            if (!allocated)
+            {
+                Memory::Deallocate(newRecordIndices, newCapacity);
+                for (InternalIndex column = 0; column < columnCount; ++column)
+                {
+                    Component::DeallocateArray(columns[column].componentId, newArrays[column], newCapacity);
+                }
+                return false;
+            }
+
+#if SECS_ENABLE_STATS
+            storage->stats.bytesMoved += RowBytes() * size;
+#endif
+
+            if (recordIndices)
+            {
+                memcpy(newRecordIndices, recordIndices, sizeof(Index) * size);
+                Memory::Deallocate(recordIndices, capacity);
+            }
+            recordIndices = newRecordIndices;
+
+            for (InternalIndex column = 0; column < columnCount; ++column)
+            {
+                Component::ResizeArray(columns[column].componentId, &componentArrays[column], newArrays[column], capacity, newCapacity, size);
+            }
+
+            capacity = newCapacity;
+
+            // The storage moved, address ordered query views must be sorted again and cached views resolved
+            storage->occupancyEpoch++;
+            rowEpoch++;
+            return true;
+        }
+#endif
+
+        /**
+         * @brief Grow the component storage so that it holds at least a given number of rows.
+         * @details All new storage is allocated before anything is moved, so on failure the
+         * archetype is left untouched.
+         * @param minCapacity The number of rows the archetype must be able to hold.
+         * @return true if the archetype can hold minCapacity rows, false if storage could not be allocated.
+         */
+        bool Grow(size_t minCapacity)
+        {
+            // Rows are numbered by Index, InvalidIndex excluded
+            if (minCapacity > IndexLimit) { return false; }
+
+            while (capacity < minCapacity)
+            {
+#if SECS_CHUNK_SIZE
+                // Growing only adds a chunk, existing rows stay where they are
+                if (!columnOffsets) { return false; }
+
+                const size_t rowsPerChunk = size_t(1) << chunkShift;
+                const size_t chunkCount = capacity >> chunkShift;
+
+                // The last chunk is only partially addressable when it would reach past IndexLimit
+                size_t newCapacity = size_t(capacity) + rowsPerChunk;
+                newCapacity = (newCapacity > IndexLimit) ? IndexLimit : newCapacity;
+                if (!GrowChangeTicks(newCapacity)) { return false; }
+
+                size_t chunkAlignment = alignof(Index);
+                EachComponent(columnsId, [&chunkAlignment](size_t componentId)
+                {
+                    size_t alignment = Component::Alignment(componentId);
+                    chunkAlignment = (alignment > chunkAlignment) ? alignment : chunkAlignment;
+                });
+
+                uint8_t* chunk = static_cast<uint8_t*>(Allocator::Allocate(chunkBytes, chunkAlignment));
+                if (!chunk) { return false; }
+
+                uint8_t** newChunks = Memory::Reallocate(chunks, chunkCount, chunkCount + 1);
+                if (!newChunks)
+                {
+                    Allocator::Deallocate(chunk, chunkBytes);
+                    return false;
+                }
+
+                // Trivially copyable columns are constructed when their rows are reserved
+                for (InternalIndex column = 0; column < columnCount; ++column)
+                {
+                    if (!columns[column].trivial)
+                    {
+                        Component::ConstructArray(columns[column].componentId, chunk + columnOffsets[column], rowsPerChunk);
+                    }
+                }
+
+                chunks = newChunks;
+                chunks[chunkCount] = chunk;
+                capacity = static_cast<Index>(newCapacity);
+
+#if SECS_ENABLE_STATS
+                // Rows stay in place, only the chunk table is copied
+                storage->stats.archetypeGrowths++;
+                storage->stats.bytesMoved += sizeof(uint8_t*) * chunkCount;
+#endif
+#else
+                if (!componentArrays) { return false; }
+
+                // Computed in size_t and clamped so that the growth cannot wrap around
+                size_t grownCapacity = (capacity == 0) ? 2 : size_t(capacity) + (capacity - capacity / 2);
+                grownCapacity = (grownCapacity < minCapacity) ? minCapacity : grownCapacity;
+                const Index newCapacity = static_cast<Index>((grownCapacity > IndexLimit) ? IndexLimit : grownCapacity);
+
+                // Growing the tick table alone leaves the archetype consistent if the columns fail to grow
+                if (!GrowChangeTicks(newCapacity)) { return false; }
+
+                if (!MoveStorage(newCapacity)) { return false; }
+
+#if SECS_ENABLE_STATS
+                storage->stats.archetypeGrowths++;
+#endif
+#endif
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Release the storage of the rows past a given capacity.
+         * @details With chunked storage only whole chunks are released, the capacity is rounded up to
+         * the next chunk. An archetype shrunk to no capacity keeps its column table and can grow again.
+         * @param newCapacity The number of rows to keep storage for, raised to size if lower.
+         * @return true if the archetype holds no more than the rounded capacity, false if storage could
+         *         not be allocated, in which case the archetype is left untouched.
+         */
+        bool Shrink(size_t newCapacity)
+        {
+            newCapacity = (newCapacity < size) ? size : newCapacity;
+            if (newCapacity >= capacity) { return true; }
+
+#if SECS_CHUNK_SIZE
+            const size_t rowsPerChunk = size_t(1) << chunkShift;
+            const size_t chunkCount = (size_t(capacity) + rowsPerChunk - 1) >> chunkShift;
+            const size_t keptChunks = (newCapacity + rowsPerChunk - 1) >> chunkShift;
+            if (keptChunks == chunkCount) { return true; }
+
+            // The smaller chunk table is allocated first, so that a failure leaves every chunk in place
+            uint8_t** newChunks = nullptr;
+            if (keptChunks)
+            {
+                newChunks = Memory::Allocate<uint8_t*>(keptChunks);
+                if (!newChunks) { return false; }
+                memcpy(newChunks, chunks, sizeof(uint8_t*) * keptChunks);
+            }
+
+            for (size_t chunk = keptChunks; chunk < chunkCount; ++chunk)
+            {
+                // Non-trivial columns are constructed for the whole chunk, see Grow()
+                for (InternalIndex column = 0; column < columnCount; ++column)
+                {
+                    if (!columns[column].trivial)
+                    {
+                        Component::DestroyArray(columns[column].componentId, chunks[chunk] + columnOffsets[column], rowsPerChunk);
+                    }
+                }
+                Allocator::Deallocate(chunks[chunk], chunkBytes);
+            }
+
+            Memory::Deallocate(chunks, chunkCount);
+            chunks = newChunks;
+            capacity = static_cast<Index>(keptChunks * rowsPerChunk);
+
+#if SECS_ENABLE_STATS
+            storage->stats.bytesMoved += sizeof(uint8_t*) * keptChunks;
+#endif
+
+            // The first chunk may be gone, address ordered query views must be sorted again
+            storage->occupancyEpoch++;
+#else
+            if (newCapacity)
+            {
+                if (!MoveStorage(static_cast<Index>(newCapacity))) { return false; }
+            }
+            else
+            {
+                for (InternalIndex column = 0; column < columnCount; ++column)
+                {
+                    Component::DeleteArray(columns[column].componentId, componentArrays[column], capacity);
+                    componentArrays[column] = nullptr;
+                }
+                Memory::Deallocate(recordIndices, capacity);
+                recordIndices = nullptr;
+                capacity = 0;
+                storage->occupancyEpoch++;
+            }
+#endif
+
+            ShrinkChangeTicks(capacity);
+            return true;
+        }
+
+        /**
+         * @brief Remove every row without releasing storage or updating entity records.
+         * @details Non-trivial components of the removed rows are reset to their default state.
+         */
+        void Clear()
+        {
+            if (columnsId != trivialId)
+            {
+                EachSpan([this](Index first, Index count)
+                {
+                    for (InternalIndex column = 0; column < columnCount; ++column)
+                    {
+                        if (columns[column].trivial) { continue; }
+
+                        uint8_t* elements = static_cast<uint8_t*>(GetColumn(column, first)) + columns[column].size * ColumnPosition(first);
+                        Component::DestroyArray(columns[column].componentId, elements, count);
+                        Component::ConstructArray(columns[column].componentId, elements, count);
+                    }
+                });
+            }
+
+            if (size) { storage->occupancyEpoch++; }
+            rowEpoch++;
+            size = 0;
+        }
+
+        /**
+         * @brief Destroy every component and release all the storage of the archetype.
+         * @details The archetype is left empty, without column table, so it cannot grow again.
+         */
+        void Release()
+        {
+#if SECS_CHUNK_SIZE
+            const size_t rowsPerChunk = size_t(1) << chunkShift;
+            const size_t chunkCount = (size_t(capacity) + rowsPerChunk - 1) >> chunkShift;
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                // Non-trivial columns are constructed for the whole chunk, see Grow()
+                for (InternalIndex column = 0; column < columnCount; ++column)
+                {
+                    if (!columns[column].trivial)
+                    {
+                        Component::DestroyArray(columns[column].componentId, chunks[chunk] + columnOffsets[column], rowsPerChunk);
+                    }
+                }
+                Allocator::Deallocate(chunks[chunk], chunkBytes);
+            }
+            Memory::Deallocate(chunks, chunkCount);
+            Memory::Deallocate(columnOffsets, size_t(columnCount) + 1);
+#else
+            for (InternalIndex column = 0; componentArrays && column < columnCount; ++column)
+            {
+                Component::DeleteArray(columns[column].componentId, componentArrays[column], capacity);
+            }
+            Memory::Deallocate(recordIndices, capacity);
+            Memory::Deallocate(componentArrays, size_t(columnCount) + 1);
+#endif
+            Memory::Deallocate(changeTicks, changeBlocks * trackedCount);
+            Memory::Deallocate(columns, size_t(columnCount) + 1);
+
+            // Reset every member through the move assignment of an empty archetype
+            *this = ArchetypeManager();
+        }
+
+        /**
+         * @brief Default construct the trivially copyable components of a range of rows.
+         * @param first The first row of the range.
+         * @param count The number of rows.
+         * @param components The binary identifier of the components to construct.
+         */
+        void ConstructRows(Index first, Index count, Component::BinaryId components)
+        {
+            if (!components) { return; }
+
+            EachSpan(first, first + count, [this, components](Index spanFirst, Index spanCount)
+            {
+                EachComponent(components, [this, spanFirst, spanCount](size_t componentId)
+                {
+                    uint8_t* column = static_cast<uint8_t*>(GetColumn(ColumnIndex(componentId), spanFirst));
+                    Component::ConstructArray(componentId,
+                        column + Component::Size(componentId) * ColumnPosition(spanFirst), spanCount);
+                });
+            });
+        }
+
+        /**
+         * @brief Reserve a row within the archetype, growing the component storage if needed.
+         * @param initialized The components the caller moves into the row, they are not constructed.
+         * @return The index of the reserved row, or InvalidIndex if storage could not be allocated.
+         */
+        Index ReserveRow(Component::BinaryId initialized = {})
+        {
+            if (size >= capacity && !Grow(size_t(size) + 1))
+            {
+                return InvalidIndex;
+            }
+
+            if (size == 0) { storage->occupancyEpoch++; }
+            ConstructRows(size, 1, trivialId & ~initialized);
+            MarkChanged(size, 1, trackedId);
+            rowsAdded++;
+            return size++;
+        }
+
+        /**
+         * @brief Reserve an EntityRecord within the archetype.
+         * @return The reserved EntityRecord, or EntityRecord::InvalidRecord() if storage could not be allocated.
+         */
+        EntityRecord& ReserveRecord()
+        {
+            EntityRecord& entityRecord = EntityRecord::Reserve();
+            if (!entityRecord.IsValid()) { return entityRecord; }
+
+            Index row = ReserveRow();
+            if (row == InvalidIndex)
+            {
+                entityRecord.Release();
+                return EntityRecord::InvalidRecord();
+            }
+
+            RecordIndex(row) = entityRecord.GetIndex();
+
+            entityRecord.archetype = static_cast<Index>(GetIndex());
+            entityRecord.row = row;
+
+            return entityRecord;
+        }
+
+        /**
+         * @brief Reserve EntityRecords for a range of consecutive rows within the archetype.
+         * @details Storage for all the rows and records is reserved up front, so either every
+         * row is reserved or none is.
+         * @param count The number of rows to reserve.
+         * @param initialized The components the caller copies into the rows, they are not constructed.
+         * @return The first reserved row, or InvalidIndex if storage could not be allocated.
+         */
+        Index ReserveRecords(Index count, Component::BinaryId initialized = {})
+        {
+            if (!Grow(size_t(size) + count) || !EntityRecord::ReserveCapacity(count))
+            {
+                return InvalidIndex;
+            }
+
+            const Index first = size;
+            const Index archetypeIndex = GetIndex();
+            for (Index row = first; row < first + count; ++row)
+            {
+                EntityRecord& entityRecord = EntityRecord::Reserve();
+                RecordIndex(row) = entityRecord.GetIndex();
+                entityRecord.archetype = archetypeIndex;
+                entityRecord.row = row;
+            }
+
+            if (size == 0 && count) { storage->occupancyEpoch++; }
+            ConstructRows(first, count, trivialId & ~initialized);
+            MarkChanged(first, count, trackedId);
+            rowsAdded += count;
+            size += count;
+            return first;
+        }
+
+        /**
+         * @brief Remove a row from the archetype by moving the last row into its place.
+         * @details The EntityRecord of the removed row is left untouched.
+         * @param row The row index to remove.
+         */
+        void EraseRow(Index row)
+        {
+            rowEpoch++;
+            if (size) size--;
+            if (size == 0) { storage->occupancyEpoch++; }
+            Index lastRow = size;
+            if (row != lastRow)
+            {
+                for (InternalIndex column = 0; column < columnCount; ++column)
+                {
+                    MoveCell(column, row, column, lastRow, *this);
+                }
+
+                EntityRecord::Get(RecordIndex(lastRow)).row = row;
+                RecordIndex(row) = RecordIndex(lastRow);
+                MarkChanged(row, 1, trackedId);
+            }
+        }
+
+        /**
+         * @brief Move one component from a row of an archetype into a row of this archetype.
+         * @param column The internal index of the destination column.
+         * @param row The destination row.
+         * @param sourceColumn The internal index of the source column.
+         * @param sourceRow The source row.
+         * @param source The archetype holding the source row, may be this archetype.
+         */
+        void MoveCell(InternalIndex column, Index row, InternalIndex sourceColumn, Index sourceRow, const ArchetypeManager& source)
+        {
+            const ColumnOperation& operation = columns[column];
+            void* dst = GetColumn(column, row);
+            void* src = source.GetColumn(sourceColumn, sourceRow);
+            if (operation.trivial)
+            {
+                memcpy(static_cast<uint8_t*>(dst) + operation.size * ColumnPosition(row),
+                    static_cast<uint8_t*>(src) + operation.size * source.ColumnPosition(sourceRow), operation.size);
+            }
+            else
+            {
+                operation.move(dst, ColumnPosition(row), src, source.ColumnPosition(sourceRow));
+            }
+        }
+
+        /**
+         * @brief Remove a row from the archetype and release its EntityRecord.
+         * @param row The row index to remove.
+         */
+        void RemoveRow(Index row)
+        {
+#if SECS_ENABLE_STATS
+            storage->stats.rowRemovals++;
+#endif
+            EraseSparse(RecordIndex(row));
+            EntityRecord::Get(RecordIndex(row)).Release();
+            EraseRow(row);
+        }
+
+        /**
+         * @brief Remove several rows from the archetype and release their EntityRecords.
+         * @details Rows are removed from the highest to the lowest, so every hole is filled
+         * from the tail with a row that is kept and no row index is invalidated along the way.
+         * The moves are then replayed column by column, one tight loop per column instead of
+         * one pass over every column per removed row.
+         * The rows are not checked: duplicates or an unsorted list would release records
+         * twice and move removed rows back into the archetype.
+         * @param rows The row indices to remove, sorted in descending order without duplicates,
+         *             so that count never exceeds size. CommandBuffer sorts and deduplicates them.
+         * @param count The number of row indices.
+         */
+        void RemoveRows(const Index* rows, size_t count)
+        {
+#if SECS_ENABLE_STATS
+            storage->stats.rowRemovals += count;
+#endif
+            for (size_t i = 0; i < count; ++i)
+            {
+                EraseSparse(RecordIndex(rows[i]));
+                EntityRecord::Get(RecordIndex(rows[i])).Release();
+            }
+
+            // Removal i moves the row at size - 1 - i into rows[i]
+            const Index end = size;
+            for (InternalIndex column = 0; column < columnCount; ++column)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const Index lastRow = static_cast<Index>(end - 1 - i);
+                    if (rows[i] != lastRow) { MoveCell(column, rows[i], column, lastRow, *this); }
+                }
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Index lastRow = static_cast<Index>(end - 1 - i);
+                if (rows[i] != lastRow)
+                {
+                    EntityRecord::Get(RecordIndex(lastRow)).row = rows[i];
+                    RecordIndex(rows[i]) = RecordIndex(lastRow);
+                    MarkChanged(rows[i], 1, trackedId);
+                }
+            }
+
+            size = static_cast<Index>(end - count);
+            rowEpoch++;
+            if (size == 0 && count) { storage->occupancyEpoch++; }
+        }
+
+        /**
+         * @brief Exchange two rows of the archetype, through the unused row past the end as scratch.
+         * @details Capacity must exceed size. The EntityRecords of both rows are updated.
+         * @param a The first row.
+         * @param b The second row, different from a.
+         */
+        void SwapRows(Index a, Index b)
+        {
+            const Index scratch = size;
+            for (InternalIndex column = 0; column < columnCount; ++column)
+            {
+                MoveCell(column, scratch, column, a, *this);
+                MoveCell(column, a, column, b, *this);
+                MoveCell(column, b, column, scratch, *this);
+            }
+
+            const Index record = RecordIndex(a);
+            RecordIndex(a) = RecordIndex(b);
+            RecordIndex(b) = record;
+            EntityRecord::Get(RecordIndex(a)).row = a;
+            EntityRecord::Get(RecordIndex(b)).row = b;
+        }
+
+        /**
+         * @brief Reorder the rows of the archetype.
+         * @details The order is stable and each row is moved at most once per cycle of the permutation.
+         * Moved rows count as written for change detection and invalidate the cache of every View.
+         * The permutation is built in the scratch list of the world, so sorting again only allocates
+         * if the archetype grew past any previous sort.
+         * @param less The function comparing two rows, returning true if the first goes before the second.
+         * @return true if the rows are sorted, false if the scratch row could not be allocated.
+         */
+        template <typename Less>
+        bool SortRows(Less less)
+        {
+            if (size < 2) { return true; }
+            if (!Grow(size_t(size) + 1)) { return false; }
+
+            Vector<Index>& scratch = storage->scratch;
+            const size_t base = scratch.size();
+            scratch.resize(base + size_t(size) * 4);
+
+            // order[i] is the row going to position i, at[i] the original row currently at position i
+            Index* order = &scratch[base];
+            Index* at = order + size;
+            Index* where = at + size;
+            Index* merged = where + size;
+            for (Index row = 0; row < size; ++row)
+            {
+                order[row] = row;
+                at[row] = row;
+                where[row] = row;
+            }
+
+            // Bottom-up merge sort, stable since ties keep taking from the left run
+            for (size_t width = 1; width < size; width *= 2)
+            {
+                for (size_t left = 0; left < size; left += 2 * width)
+                {
+                    const size_t middle = (size - left > width) ? left + width : size;
+                    const size_t right = (size - middle > width) ? middle + width : size;
+                    size_t i = left;
+                    size_t j = middle;
+                    for (size_t k = left; k < right; ++k)
+                    {
+                        merged[k] = (i < middle && (j >= right || !less(order[j], order[i]))) ? order[i++] : order[j++];
+                    }
+                }
+                std::swap(order, merged);
+            }
+
+            for (Index row = 0; row < size; ++row)
+            {
+                const Index source = where[order[row]];
+                if (source == row) { continue; }
+
+                SwapRows(row, source);
+                std::swap(at[row], at[source]);
+                where[at[row]] = row;
+                where[at[source]] = source;
+            }
+            scratch.resize(base);
+
+            MarkChanged(0, size, trackedId);
+            rowEpoch++;
+            return true;
+        }
+
+        /**
+         * @brief Move an entity from its current archetype into another archetype.
+         * @details Components shared by both archetypes are moved, components only present in the
+         * target archetype are left default constructed. The entity keeps its EntityRecord, so
+         * existing references to it stay valid.
+         * @param record The EntityRecord of the entity to move.
+         * @param targetIndex The index of the target archetype manager.
+         * @return true if the entity is in the target archetype, false if storage could not be allocated.
+         */
+        static bool MoveEntity(EntityRecord& record, Index targetIndex)
+        {
+            if (record.archetype == targetIndex) { return true; }
+
+            ArchetypeManager& target = Get(targetIndex);
+            ArchetypeManager& source = Get(record.archetype);
+            Index sourceRow = record.row;
+            Index row = target.ReserveRow(source.columnsId);
+            if (row == InvalidIndex) { return false; }
+
+            for (InternalIndex column = 0; column < target.columnCount; ++column)
+            {
+                InternalIndex srcColumn = source.ColumnIndex(target.columns[column].componentId);
+                if (srcColumn != Unused) { target.MoveCell(column, row, srcColumn, sourceRow, source); }
+            }
+            target.RecordIndex(row) = record.GetIndex();
+            source.EraseRow(sourceRow);
+
+            record.archetype = targetIndex;
+            record.row = row;
+#if SECS_ENABLE_STATS
+            storage->stats.entityMoves++;
+#endif
+            return true;
+        }
+    };
+
+    // Defined out of the class, the member initializers of Storage are only usable once ArchetypeManager is complete
+    inline ArchetypeManager::Storage ArchetypeManager::defaultStorage;
+    inline SECS_THREAD_LOCAL ArchetypeManager::Storage* ArchetypeManager::storage = &ArchetypeManager::defaultStorage;
 }
@@ -0,0 +1,229 @@
+#pragma once
+
+/**
+ * @file BitSet.hpp
+ * @brief Fixed-size multi-word bit set for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the BitSet class used as the component binary identifier.
+ * A single word limits a program to 32 component types on 32-bit targets and
+ * 64 on PC, so the identifier is made of SECS_COMPONENT_WORDS machine words
+ * instead.
+ *
+ * Every operation runs over the whole fixed-size word array without early
+ * exits, so with one word it compiles to the same instructions as a plain
+ * integer, and with several words compilers can unroll and vectorize the
+ * loops.
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see Component::BinaryId For the identifier built on top of it
+ * @see Config.hpp For SECS_COMPONENT_WORDS
+ */
+
+#include <stddef.h>
+#include <limits.h>
+#include <bit>
+
+namespace SECS
+{
+    /**
+     * @brief Fixed-size set of bits stored in machine words
+     *
+     * @details
+     * Offers the bitwise operators of an unsigned integer, plus set queries
+     * (Contains(), Intersects()), in-order traversal of the set bits and a
+     * rank query counting the set bits below a position.
+     *
+     * @tparam Words The number of machine words holding the bits.
+     */
+    template <size_t Words>
+    class BitSet
+    {
+        static_assert(Words > 0, "A BitSet needs at least one word");
+
+    public:
+        using Word = size_t;                                        /**< Storage unit of the bits. */
+        static inline constexpr size_t WordBits = sizeof(Word) * CHAR_BIT;  /**< Number of bits per word. */
+        static inline constexpr size_t Bits = Words * WordBits;            /**< Number of bits in the set. */
+
+    private:
+        Word words[Words] = {};
+
+    public:
+        /**
+         * @brief Default constructor for creating an empty set.
+         */
+        constexpr BitSet() = default;
+
+        /**
+         * @brief Create a set holding a single bit.
+         * @param index The position of the bit, lower than Bits.
+         * @return The set.
+         */
+        static constexpr BitSet Bit(size_t index)
+        {
+            BitSet result;
+            result.words[index / WordBits] = Word(1) << (index % WordBits);
+            return result;
+        }
+
+        /**
+         * @brief Check whether a bit is set.
+         * @param index The position of the bit, lower than Bits.
+         * @return true if the bit is set.
+         */
+        constexpr bool Test(size_t index) const
+        {
+            return (words[index / WordBits] >> (index % WordBits)) & 1;
+        }
+
+        /**
+         * @brief Check whether every bit of another set is also set in this one.
+         * @param other The set to look for.
+         * @return true if other is a subset of this set.
+         */
+        constexpr bool Contains(const BitSet& other) const
+        {
+            Word missing = 0;
+            for (size_t i = 0; i < Words; ++i)
+            {
+                missing |= other.words[i] & ~words[i];
+            }
+            return missing == 0;
+        }
+
+        /**
+         * @brief Check whether this set shares at least one bit with another set.
+         * @param other The other set.
+         * @return true if the intersection of the sets is not empty.
+         */
+        constexpr bool Intersects(const BitSet& other) const
+        {
+            Word common = 0;
+            for (size_t i = 0; i < Words; ++i)
+            {
+                common |= other.words[i] & words[i];
+            }
+            return common != 0;
+        }
+
+        /**
+         * @brief Count the set bits.
+         * @return The number of set bits.
+         */
+        constexpr size_t Count() const
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < Words; ++i)
+            {
+                count += std::popcount(words[i]);
+            }
+            return count;
+        }
+
+        /**
+         * @brief Count the set bits at positions lower than a given one.
+         * @param index The position, lower than Bits.
+         * @return The number of set bits below index.
+         */
+        constexpr size_t Rank(size_t index) const
+        {
+            const size_t word = index / WordBits;
+            size_t count = 0;
+            for (size_t i = 0; i < word; ++i)
+            {
+                count += std::popcount(words[i]);
+            }
+            return count + std::popcount(words[word] & ((Word(1) << (index % WordBits)) - 1));
+        }
+
+        /**
+         * @brief Combine the words into one, for hashing.
+         * @return The exclusive or of the words, each rotated by its position.
+         */
+        constexpr Word Fold() const
+        {
+            Word folded = 0;
+            for (size_t i = 0; i < Words; ++i)
+            {
+                folded ^= std::rotl(words[i], static_cast<int>(i));
+            }
+            return folded;
+        }
+
+        /**
+         * @brief Call a function with the position of each set bit, in increasing order.
+         * @param lambda The function taking the position of a bit.
+         */
+        template <typename Lambda>
+        constexpr void ForEach(Lambda lambda) const
+        {
+            for (size_t i = 0; i < Words; ++i)
+            {
+                for (Word word = words[i]; word; word &= word - 1)
+                {
+                    lambda(i * WordBits + std::countr_zero(word));
+                }
+            }
+        }
+
+        /**
+         * @brief Check whether any bit is set.
+         */
+        constexpr explicit operator bool() const
+        {
+            Word any = 0;
+            for (size_t i = 0; i < Words; ++i)
+            {
+                any |= words[i];
+            }
+            return any != 0;
+        }
+
+        constexpr BitSet& operator|=(const BitSet& other)
+        {
+            for (size_t i = 0; i < Words; ++i) { words[i] |= other.words[i]; }
+            return *this;
+        }
+
+        constexpr BitSet& operator&=(const BitSet& other)
+        {
+            for (size_t i = 0; i < Words; ++i) { words[i] &= other.words[i]; }
+            return *this;
+        }
+
+        constexpr BitSet& operator^=(const BitSet& other)
+        {
+            for (size_t i = 0; i < Words; ++i) { words[i] ^= other.words[i]; }
+            return *this;
+        }
+
+        constexpr BitSet operator~() const
+        {
+            BitSet result;
+            for (size_t i = 0; i < Words; ++i) { result.words[i] = ~words[i]; }
+            return result;
+        }
+
+        friend constexpr BitSet operator|(BitSet a, const BitSet& b) { return a |= b; }
+        friend constexpr BitSet operator&(BitSet a, const BitSet& b) { return a &= b; }
+        friend constexpr BitSet operator^(BitSet a, const BitSet& b) { return a ^= b; }
+
+        friend constexpr bool operator==(const BitSet& a, const BitSet& b)
+        {
+            Word difference = 0;
+            for (size_t i = 0; i < Words; ++i)
+            {
+                difference |= a.words[i] ^ b.words[i];
+            }
+            return difference == 0;
+        }
+
+        friend constexpr bool operator!=(const BitSet& a, const BitSet& b) { return !(a == b); }
+    };
+}
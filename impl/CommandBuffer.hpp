@@ -0,0 +1,338 @@
+#pragma once
+
+/**
+ * @file CommandBuffer.hpp
+ * @brief Deferred structural changes for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the CommandBuffer class, which records entity creation,
+ * destruction and component additions/removals and applies them later in a
+ * single batch. Structural changes move rows inside archetype storage, so
+ * applying them while World::EntityIterator::Iterate is walking that storage
+ * would skip rows or leave the iterator with dangling column pointers.
+ * Recording them during the iteration and flushing afterwards makes it safe
+ * for systems to mutate the world freely.
+ *
+ * @par Batched Destruction:
+ * Destructions are applied last, grouped per archetype and removed from the
+ * highest row to the lowest. Each hole is then filled from the tail of the
+ * archetype with a row that is kept, so a whole wave of destroyed entities
+ * costs one compaction pass per archetype.
+ *
+ * @par Thread Safety:
+ * This class is NOT thread-safe. External synchronization is required
+ * for concurrent access from multiple threads.
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see World::EntityIterator For the iteration the buffer is meant to be used from
+ */
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+#include "World.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Records structural changes to apply them later in one batch
+     *
+     * @details
+     * Every operation that changes which archetype an entity lives in (creation,
+     * destruction, Add and Remove) can be recorded in a CommandBuffer instead of
+     * being applied immediately. Flush() then applies the recorded operations:
+     * creations, additions and removals in the order they were recorded,
+     * followed by all destructions.
+     *
+     * Create and Add commands taking a lambda store a copy of it inside the
+     * buffer, the lambda is called on the new components when the command is
+     * applied. Such lambdas must be trivially copyable, which holds for lambdas
+     * capturing values of plain types, pointers or references.
+     *
+     * @par Memory Management:
+     * Commands are stored in containers drawing their memory from the selected
+     * allocator. The containers keep their capacity across flushes, so a buffer
+     * reused every frame stops allocating once it reached its peak size.
+     *
+     * @par Usage Examples:
+     * @code{.cpp}
+     * CommandBuffer commands;
+     *
+     * World::EntityIterator it;
+     * it.Iterate([&it, &commands](Position* pos, Health* hp)
+     * {
+     *     if (hp->current <= 0)
+     *     {
+     *         commands.Destroy(it.GetCurrentEntity());
+     *         float x = pos->x, y = pos->y;
+     *         commands.Create([x, y](Position* p, Explosion* e) {
+     *             p->x = x;
+     *             p->y = y;
+     *             e->frames = 20;
+     *         });
+     *     }
+     * });
+     *
+     * commands.Flush();
+     * @endcode
+     *
+     * @warning Commands must not be recorded into a buffer from a lambda
+     *          executed by that same buffer's Flush().
+     */
+    class CommandBuffer
+    {
+        /**
+         * @brief A recorded creation, addition or removal.
+         */
+        struct Command
+        {
+            void (*execute)(EntityReference& target, void* payload);
+            EntityReference target;
+            size_t payload;
+        };
+
+        /**
+         * @brief A destruction resolved to the row it removes.
+         */
+        struct PendingDestroy
+        {
+            Index archetype;
+            Index row;
+
+            bool operator<(const PendingDestroy& other) const
+            {
+                return (archetype != other.archetype) ? archetype > other.archetype : row > other.row;
+            }
+
+            bool operator==(const PendingDestroy& other) const
+            {
+                return archetype == other.archetype && row == other.row;
+            }
+        };
+
+        Vector<Command> commands;
+        Vector<max_align_t> payloads;
+        Vector<EntityReference> destroys;
+        Vector<PendingDestroy> pending;
+        Vector<Index> rows;
+
+        /**
+         * @brief Store a copy of a lambda in the payload buffer.
+         * @tparam Lambda The lambda type.
+         * @param lambda The lambda to store.
+         * @return The offset of the stored lambda in the payload buffer.
+         */
+        template <typename Lambda>
+        size_t StorePayload(const Lambda& lambda)
+        {
+            static_assert(std::is_trivially_copyable_v<Lambda>,
+                "Lambdas recorded in a CommandBuffer must be trivially copyable");
+            static_assert(alignof(Lambda) <= alignof(max_align_t),
+                "Lambdas recorded in a CommandBuffer must not be over-aligned");
+
+            size_t offset = payloads.size();
+            payloads.resize(offset + (sizeof(Lambda) + sizeof(max_align_t) - 1) / sizeof(max_align_t));
+            new (&payloads[offset]) Lambda(lambda);
+            return offset;
+        }
+
+        /**
+         * @brief Record a command.
+         * @param execute The function applying the command.
+         * @param target The entity the command applies to.
+         * @param payload The offset of the command's lambda in the payload buffer.
+         */
+        void Record(void (*execute)(EntityReference&, void*), const EntityReference& target, size_t payload = 0)
+        {
+            commands.push_back(Command{ execute, target, payload });
+        }
+
+        /**
+         * @brief Apply all the recorded destructions, batched per archetype.
+         */
+        void FlushDestroys()
+        {
+            for (const EntityReference& entity : destroys)
+            {
+                if (entity.recordIndex == InvalidIndex) { continue; }
+
+                const EntityRecord& record = EntityRecord::Get(entity.recordIndex);
+                if (entity.Holds(record))
+                {
+                    pending.push_back(PendingDestroy{ record.archetype, record.row });
+                }
+            }
+
+            std::sort(pending.begin(), pending.end());
+
+            size_t begin = 0;
+            while (begin < pending.size())
+            {
+                const Index archetype = pending[begin].archetype;
+                rows.clear();
+
+                size_t end = begin;
+                for (; end < pending.size() && pending[end].archetype == archetype; ++end)
+                {
+                    // The same entity may have been recorded several times
+                    if (end == begin || !(pending[end] == pending[end - 1]))
+                    {
+                        rows.push_back(pending[end].row);
+                    }
+                }
+
+                ArchetypeManager& manager = ArchetypeManager::Get(archetype);
+                if (manager.id & Component::RemoveHookMask)
+                {
+                    // Every row is still in place until RemoveRows() compacts the archetype
+                    for (Index row : rows)
+                    {
+                        EntityReference::RunHooks(EntityRecord::Get(manager.RecordIndex(row)), manager.id, true);
+                    }
+                }
+
+                manager.RemoveRows(rows.data(), rows.size());
+                begin = end;
+            }
+
+            pending.clear();
+            destroys.clear();
+        }
+
+    public:
+        /**
+         * @brief Default constructor for creating an empty CommandBuffer.
+         */
+        CommandBuffer() = default;
+
+        /**
+         * @brief Record the creation of an entity with explicitly specified component types.
+         * @details The components are left default constructed, see World::CreateEntity<Ts...>().
+         * @tparam Ts The component types of the entity.
+         */
+        template <typename... Ts>
+        void Create()
+        {
+            Record([](EntityReference&, void*) { World::CreateEntity<Ts...>(); }, EntityReference());
+        }
+
+        /**
+         * @brief Record the creation of an entity with components initialized through a lambda function.
+         * @details The lambda is stored in the buffer and called when the entity is created, see
+         * World::CreateEntity(Lambda).
+         * @param lambda A trivially copyable callable object taking pointers to the component types.
+         */
+        template <typename Lambda>
+        void Create(Lambda lambda)
+        {
+            Record([](EntityReference&, void* payload)
+            {
+                World::CreateEntity(*static_cast<Lambda*>(payload));
+            }, EntityReference(), StorePayload(lambda));
+        }
+
+        /**
+         * @brief Record the destruction of an entity.
+         * @details Destroying an entity that is already destroyed when the buffer is flushed,
+         * or recorded several times, has no effect.
+         * @param entity The entity to destroy.
+         */
+        void Destroy(const EntityReference& entity)
+        {
+            destroys.push_back(entity);
+        }
+
+        /**
+         * @brief Record the addition of components to an entity, see EntityReference::Add<Ts...>().
+         * @tparam Ts The component types to add.
+         * @param entity The entity to add the components to.
+         */
+        template <typename... Ts>
+        void Add(const EntityReference& entity)
+        {
+            Record([](EntityReference& target, void*) { target.Add<Ts...>(); }, entity);
+        }
+
+        /**
+         * @brief Record the addition of components to an entity initialized through a lambda function.
+         * @details The lambda is stored in the buffer and called once the components were added,
+         * see EntityReference::Add(Lambda).
+         * @param entity The entity to add the components to.
+         * @param lambda A trivially copyable callable object taking pointers to the component types to add.
+         */
+        template <typename Lambda>
+        void Add(const EntityReference& entity, Lambda lambda)
+        {
+            Record([](EntityReference& target, void* payload)
+            {
+                target.Add(*static_cast<Lambda*>(payload));
+            }, entity, StorePayload(lambda));
+        }
+
+        /**
+         * @brief Record the removal of components from an entity, see EntityReference::Remove<Ts...>().
+         * @tparam Ts The component types to remove.
+         * @param entity The entity to remove the components from.
+         */
+        template <typename... Ts>
+        void Remove(const EntityReference& entity)
+        {
+            Record([](EntityReference& target, void*) { target.Remove<Ts...>(); }, entity);
+        }
+
+        /**
+         * @brief Apply every recorded command and empty the buffer.
+         *
+         * @details
+         * Creations, additions and removals are applied in the order they were
+         * recorded. Destructions are applied last, sorted per archetype. Commands
+         * whose entity is no longer valid, or that fail to allocate storage, are
+         * dropped the same way their immediate counterparts fail.
+         *
+         * @return bool Returns false, keeping every command recorded, if a
+         *              World::IterateParallel dispatch is in progress.
+         *
+         * @warning Must not be called while an iteration over the world is in progress.
+         */
+        bool Flush()
+        {
+            if (ArchetypeManager::IsLocked()) { return false; }
+
+            for (Command& command : commands)
+            {
+                command.execute(command.target, payloads.data() + command.payload);
+            }
+
+            commands.clear();
+            payloads.clear();
+
+            FlushDestroys();
+            return true;
+        }
+
+        /**
+         * @brief Discard every recorded command without applying it.
+         */
+        void Clear()
+        {
+            commands.clear();
+            payloads.clear();
+            destroys.clear();
+        }
+
+        /**
+         * @brief Check whether the buffer holds recorded commands.
+         * @return true if there is nothing to flush.
+         */
+        bool Empty() const
+        {
+            return commands.empty() && destroys.empty();
+        }
+    };
+}
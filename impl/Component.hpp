@@ -38,6 +38,7 @@
  * 
  * @par Memory Management:
  * - Component arrays are managed through type-erased function pointers
+ * - Storage is obtained through the SECS_ALLOCATOR hook (see Allocator.hpp)
  * - Allocation failures are handled gracefully without exceptions
  * - Move semantics are used for efficient component relocation
  * - Default constructors are used for cleanup when available
@@ -67,6 +68,7 @@
  * constexpr auto bothBinary = posBinary | velBinary;        // 0b11
  * ```
  * 
+ * @see BitSet For the binary ID representation
  * @see ArchetypeManager For component storage and archetype management
  * @see EntityRecord For entity metadata and lifecycle
  * @see World For high-level component operations
@@ -75,10 +77,72 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <limits.h>
-#include <vector>
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Config.hpp"
+#include "Allocator.hpp"
+#include "BitSet.hpp"
 
 namespace SECS
 {
+    class EntityReference;
+
+    /**
+     * @brief Trait opting a component type into change detection
+     * 
+     * @details
+     * Columns of tracked components record, per block of SECS_CHANGE_BLOCK_ROWS
+     * rows, the tick at which they were last written to. Writes are mutable
+     * accesses through EntityReference::Access() or non-const iteration
+     * parameters, plus rows being created or moved. Changed<> query filters
+     * then only visit the blocks written since the previous iteration.
+     * 
+     * Untracked components, the default, pay nothing for it.
+     * 
+     * @par Example:
+     * ```cpp
+     * struct Position { float x, y; };
+     * template <> struct SECS::TrackChanges<Position> : std::true_type {};
+     * ```
+     * 
+     * @tparam T The component type.
+     */
+    template <typename T>
+    struct TrackChanges : std::false_type {};
+
+    /**
+     * @brief Trait moving a component type out of archetypes into a sparse set
+     * 
+     * @details
+     * Sparse components are kept in a paged sparse set keyed by entity record
+     * instead of an archetype column, and are not part of archetype ids. Adding
+     * or removing one is O(1) and leaves the other components of the entity in
+     * place, which suits components toggled every few frames such as hit
+     * markers or selection tags. Reading one costs an extra indirection.
+     * 
+     * Sparse components can be accessed, added and removed through
+     * EntityReference, are valid parameters of EntityIterator::Iterate()
+     * alongside archetype components, and may be named by With, Without and
+     * Optional filters of every iteration, which check them on each row. The
+     * paths handing out whole archetypes or columns (CreateEntity<Ts...>(),
+     * prefabs, the parameters of IterateChunks(), IterateParallel(),
+     * IterateFused(), IterateHierarchy() and schedules, hooks) reject them at
+     * compile time. They cannot be combined with TrackChanges.
+     * 
+     * @par Example:
+     * ```cpp
+     * struct Hit { int damage; };
+     * template <> struct SECS::SparseStorage<Hit> : std::true_type {};
+     * ```
+     * 
+     * @tparam T The component type.
+     */
+    template <typename T>
+    struct SparseStorage : std::false_type {};
+
     /**
      * @brief Component type management and type-erased operations
      * 
@@ -108,6 +172,9 @@ namespace SECS
      * - Health:   ID=2, Binary=0b100
      * - Position+Velocity: Binary=0b011
      * 
+     * Binary IDs are BitSet values spanning SECS_COMPONENT_WORDS machine
+     * words, which sets the maximum number of component types.
+     * 
      * @par Type-Erased Operations:
      * The class maintains function pointers for common operations on component
      * arrays, allowing the archetype system to manipulate arrays of any
@@ -170,20 +237,34 @@ namespace SECS
         }
 
         /**
-         * @brief Deletes an array of type T.
+         * @brief Destroys the elements of an array of type T and releases its storage.
          *
          * @tparam T The type of the array elements.
          * @param array Pointer to the array to be deleted.
+         * @param capacity The number of elements in the array.
          */
         template<typename T>
-        static void DeleteArray(void* array)
+        static void DeleteArray(void* array, size_t capacity)
         {
-            delete[] static_cast<T*>(array);
+            T* elements = static_cast<T*>(array);
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                for (size_t i = 0; i < capacity; ++i)
+                {
+                    elements[i].~T();
+                }
+            }
+
+            Memory::Deallocate(elements, capacity);
         }
 
         /**
          * @brief Moves an element from one array to another.
          *
+         * @details
+         * Trivially copyable elements are copied bytewise and the source slot is left as is,
+         * it is default constructed again when a row reuses it (see IsTrivial()).
+         *
          * @tparam T The type of the array elements.
          * @param dstArray Pointer to the destination array.
          * @param dstPos The position in the destination array.
@@ -193,71 +274,166 @@ namespace SECS
         template<typename T>
         static void MoveElement(void* dstArray, size_t dstPos, void* srcArray, size_t srcPos)
         {
-            // Move data from source object to destination object
-            static_cast<T*>(dstArray)[dstPos] = std::move(static_cast<T*>(srcArray)[srcPos]);
-
-            // Check if the type T has a default constructor
-            if constexpr (std::is_default_constructible_v<T>)
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                memcpy(&static_cast<T*>(dstArray)[dstPos], &static_cast<T*>(srcArray)[srcPos], sizeof(T));
+            }
+            else
             {
-                // Reset the original object to a default state
-                new (&static_cast<T*>(srcArray)[srcPos]) T{};
+                // Move data from source object to destination object
+                static_cast<T*>(dstArray)[dstPos] = std::move(static_cast<T*>(srcArray)[srcPos]);
+
+                // Check if the type T has a default constructor
+                if constexpr (std::is_default_constructible_v<T>)
+                {
+                    // Reset the original object to a default state
+                    new (&static_cast<T*>(srcArray)[srcPos]) T{};
+                }
             }
         }
 
         /**
-         * @brief Resizes an array of a specific component type.
+         * @brief Moves the content of an array of type T into new, uninitialized storage.
+         *
+         * @details
+         * The first moveCount elements are move constructed into the new storage and the remaining
+         * ones are default constructed. Every element of the original array is then destroyed,
+         * releasing the original storage is left to the caller.
+         *
+         * Trivially copyable elements are copied with a single memcpy, and the remaining storage is
+         * left uninitialized until rows are reserved in it (see IsTrivial()).
          *
          * @tparam T The type of the array elements.
-         * @param ptrToArray Pointer to the array to be resized.
-         * @param newSize The new size of the array.
-         * @param moveCount The number of elements to move from the original array to the resized array.
-         * @return true If the array was resized successfully.
-         * @return false If resizing failed.
+         * @param dstArray Pointer to the uninitialized storage.
+         * @param dstCapacity The number of elements the new storage holds.
+         * @param srcArray Pointer to the original array, may be nullptr if srcCapacity is 0.
+         * @param srcCapacity The number of elements in the original array.
+         * @param moveCount The number of elements to move from the original array.
          */
         template <typename T>
-        static bool ResizeArray(void** ptrToArray, size_t newSize, size_t moveCount)
+        static void ResizeArray(void* dstArray, size_t dstCapacity, void* srcArray, size_t srcCapacity, size_t moveCount)
         {
-            // Allocate memory for the resized array
-            T* newArray = new T[newSize];
-            if (!newArray)
+            T* newArray = static_cast<T*>(dstArray);
+            T* originalArray = static_cast<T*>(srcArray);
+
+            if constexpr (std::is_trivially_copyable_v<T>)
             {
-                return false; // Return false if allocation fails
+                (void)dstCapacity;
+                (void)srcCapacity;
+                if (moveCount)
+                {
+                    memcpy(newArray, originalArray, sizeof(T) * moveCount);
+                }
+                return;
             }
 
-            T* originalArray = *reinterpret_cast<T**>(ptrToArray);
-
             // Move elements from the original array to the resized array
             for (size_t i = 0; i < moveCount; ++i)
             {
-                newArray[i] = std::move(originalArray[i]);
+                new (&newArray[i]) T(std::move(originalArray[i]));
             }
 
-            // Delete the original array
-            delete[] originalArray;
+            for (size_t i = moveCount; i < dstCapacity; ++i)
+            {
+                new (&newArray[i]) T{};
+            }
 
-            // Update the pointer to point to the resized array
-            *reinterpret_cast<T**>(ptrToArray) = newArray;
+            for (size_t i = 0; i < srcCapacity; ++i)
+            {
+                originalArray[i].~T();
+            }
+        }
 
-            return true; // Return true if resizing is successful
+        /**
+         * @brief Default constructs elements of type T in raw memory.
+         *
+         * @tparam T The type of the array elements.
+         * @param array Pointer to the raw memory, suitably aligned for T.
+         * @param count The number of elements to construct.
+         */
+        template <typename T>
+        static void ConstructArray(void* array, size_t count)
+        {
+            T* elements = static_cast<T*>(array);
+            if constexpr (std::is_trivially_default_constructible_v<T>)
+            {
+                // Value initialization of a trivial type zero-fills it
+                memset(elements, 0, sizeof(T) * count);
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    new (&elements[i]) T{};
+                }
+            }
+        }
+
+        /**
+         * @brief Destroys elements of type T without releasing their storage.
+         *
+         * @tparam T The type of the array elements.
+         * @param array Pointer to the elements.
+         * @param count The number of elements to destroy.
+         */
+        template <typename T>
+        static void DestroyArray(void* array, size_t count)
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                T* elements = static_cast<T*>(array);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    elements[i].~T();
+                }
+            }
         }
+
         // Typedefs for function pointers
-        using DeleteArrayInterface = void (*)(void* array);
+        using DeleteArrayInterface = void (*)(void* array, size_t capacity);
         using MoveElementInterface = void(*)(void* dstArray, size_t dstPos, void* srcArray, size_t srcPos);
-        using ResizeArrayInterface = bool(*)(void** ptrToArray, size_t newSize, size_t moveCount);
+        using ResizeArrayInterface = void(*)(void* dstArray, size_t dstCapacity, void* srcArray, size_t srcCapacity, size_t moveCount);
+        using ConstructArrayInterface = void(*)(void* array, size_t count);
+        using DestroyArrayInterface = void(*)(void* array, size_t count);
 
+    public:
+        using HookCallback = void (*)();    /**< Type-erased user callback, cast back to its real type by the invoker. */
+
+        /**
+         * @brief A callback registered for a component type, see World::OnAdd() and World::OnRemove().
+         */
+        struct Hook
+        {
+            void (*invoke)(HookCallback callback, const EntityReference& entity, void* component) = nullptr;   /**< Restores the callback type and calls it. */
+            HookCallback callback = nullptr;                                                                   /**< The registered callback. */
+        };
+
+    private:
         // Struct to hold operation function pointers
         struct Operation
         {
             DeleteArrayInterface DeleteArray;       /**< Function pointer to delete an array. */
             MoveElementInterface MoveElement;       /**< Function pointer to move an element from one array to another. */
-            ResizeArrayInterface ResizeArray;       /**< Function pointer to resize an array. */
+            ResizeArrayInterface ResizeArray;       /**< Function pointer to move an array into new storage. */
+            ConstructArrayInterface ConstructArray; /**< Function pointer to construct elements in raw memory. */
+            DestroyArrayInterface DestroyArray;     /**< Function pointer to destroy elements in place. */
+            size_t size;                            /**< Size of one element in bytes. */
+            size_t alignment;                       /**< Required alignment of one element in bytes. */
+            bool trivial;                           /**< Elements are trivially copyable. */
+            Hook onAdd = {};                        /**< Called when an entity gains the component. */
+            Hook onRemove = {};                     /**< Called when an entity loses the component or is destroyed. */
         };
 
-        static inline std::vector<Operation> OperationList;    /**< Vector to hold operation function pointers. */
+        static inline Vector<Operation> OperationList;    /**< Vector to hold operation function pointers. */
 
     public:
-        using BinaryId = size_t;                          /**< Alias for component ID in binary format. */
-        static inline constexpr size_t MaxComponentTypes = sizeof(BinaryId) * CHAR_BIT;   /**< Maximum number of component types. */
+        using BinaryId = BitSet<SECS_COMPONENT_WORDS>;    /**< Alias for component ID in binary format. */
+        static inline constexpr size_t MaxComponentTypes = BinaryId::Bits;   /**< Maximum number of component types. */
+        static inline BinaryId TagMask;                   /**< Binary IDs of the registered tags (empty component types). */
+        static inline BinaryId TrackedMask;               /**< Binary IDs of the components opted into change detection. */
+        static inline BinaryId AddHookMask;               /**< Binary IDs of the components with an OnAdd hook. */
+        static inline BinaryId RemoveHookMask;            /**< Binary IDs of the components with an OnRemove hook. */
+        using MoveElementFunction = MoveElementInterface; /**< Type-erased element move operation. */
 
         /**
          * @brief Retrieves the ID of a component type.
@@ -277,26 +453,73 @@ namespace SECS
         {
             constexpr size_t id = Id<T>;
             constexpr size_t size = id + 1;
+            static_assert(id < MaxComponentTypes, "Too many component types, increase SECS_COMPONENT_WORDS");
 
             if (OperationList.size() < size)
             {
                 OperationList.resize(size);
             }
 
-            OperationList[id] = Operation(&DeleteArray<T>, &MoveElement<T>, &ResizeArray<T>);
+            // Tags only take up a bit in the binary ID, they never get a column
+            constexpr bool isTag = std::is_empty_v<T>;
+            OperationList[id] = Operation(&DeleteArray<T>, &MoveElement<T>, &ResizeArray<T>,
+                &ConstructArray<T>, &DestroyArray<T>, isTag ? 0 : sizeof(T), alignof(T), std::is_trivially_copyable_v<T>);
 
-            return (BinaryId)1 << id;
+            if constexpr (isTag)
+            {
+                TagMask |= BinaryId::Bit(id);
+            }
+
+            if constexpr (TrackChanges<T>::value)
+            {
+                static_assert(!isTag, "Tags have no column whose changes could be tracked");
+                TrackedMask |= BinaryId::Bit(id);
+            }
+
+            return BinaryId::Bit(id);
         }();
 
+        /**
+         * @brief Allocates uninitialized storage for an array of a specific component type.
+         *
+         * @param componentId The ID of the component type.
+         * @param capacity The number of elements.
+         * @return A pointer to the storage, or nullptr if allocation fails.
+         */
+        static void* AllocateArray(size_t componentId, size_t capacity)
+        {
+            const Operation& operation = OperationList[componentId];
+            return Allocator::Allocate(operation.size * capacity, operation.alignment);
+        }
+
+        /**
+         * @brief Releases storage obtained from AllocateArray() without destroying its elements.
+         *
+         * @param componentId The ID of the component type.
+         * @param array Pointer to the storage, may be nullptr.
+         * @param capacity The number of elements the storage was allocated for.
+         */
+        static void DeallocateArray(size_t componentId, void* array, size_t capacity)
+        {
+            if (array)
+            {
+                Allocator::Deallocate(array, OperationList[componentId].size * capacity);
+            }
+        }
+
         /**
          * @brief Deletes an array of a specific component type.
          *
          * @param componentId The ID of the component type.
          * @param array Pointer to the array to be deleted.
+         * @param capacity The number of elements in the array.
          */
-        static void DeleteArray(size_t componentId, void* array)
+        static void DeleteArray(size_t componentId, void* array, size_t capacity)
         {
-            OperationList[componentId].DeleteArray(array);
+            if (array)
+            {
+                OperationList[componentId].DeleteArray(array, capacity);
+            }
         }
 
         /**
@@ -314,18 +537,134 @@ namespace SECS
         }
 
         /**
-         * @brief Resizes an array of a specific component type.
+         * @brief Retrieves the element move operation of a specific component type.
          *
          * @param componentId The ID of the component type.
-         * @param ptrToArray Pointer to the array to be resized.
-         * @param newSize The new size of the array.
+         * @return The function moving one element between two arrays of the component type.
+         */
+        static MoveElementFunction MoveFunction(size_t componentId)
+        {
+            return OperationList[componentId].MoveElement;
+        }
+
+        /**
+         * @brief Resizes an array of a specific component type into storage obtained from AllocateArray().
+         *
+         * @details
+         * Splitting allocation from the move lets callers allocate every column first and only
+         * commit once all allocations succeeded. This step cannot fail.
+         *
+         * @param componentId The ID of the component type.
+         * @param ptrToArray Pointer to the array to be resized, updated to point to newArray.
+         * @param newArray Uninitialized storage for newCapacity elements.
+         * @param oldCapacity The number of elements in the original array.
+         * @param newCapacity The number of elements in the resized array.
          * @param moveCount The number of elements to move from the original array to the resized array.
-         * @return true If the array was resized successfully.
-         * @return false If resizing failed.
          */
-        static bool ResizeArray(size_t componentId, void** ptrToArray, size_t newSize, size_t moveCount)
+        static void ResizeArray(size_t componentId, void** ptrToArray, void* newArray, size_t oldCapacity, size_t newCapacity, size_t moveCount)
+        {
+            OperationList[componentId].ResizeArray(newArray, newCapacity, *ptrToArray, oldCapacity, moveCount);
+            DeallocateArray(componentId, *ptrToArray, oldCapacity);
+            *ptrToArray = newArray;
+        }
+
+        /**
+         * @brief Default constructs elements of a specific component type in raw memory.
+         *
+         * @param componentId The ID of the component type.
+         * @param array Pointer to the raw memory, suitably aligned for the component type.
+         * @param count The number of elements to construct.
+         */
+        static void ConstructArray(size_t componentId, void* array, size_t count)
+        {
+            OperationList[componentId].ConstructArray(array, count);
+        }
+
+        /**
+         * @brief Destroys elements of a specific component type without releasing their storage.
+         *
+         * @param componentId The ID of the component type.
+         * @param array Pointer to the elements.
+         * @param count The number of elements to destroy.
+         */
+        static void DestroyArray(size_t componentId, void* array, size_t count)
+        {
+            OperationList[componentId].DestroyArray(array, count);
+        }
+
+        /**
+         * @brief Retrieves the number of component IDs in use.
+         *
+         * @return One past the highest registered component ID.
+         */
+        static size_t Count()
+        {
+            return OperationList.size();
+        }
+
+        /**
+         * @brief Retrieves the size in bytes of a specific component type.
+         *
+         * @param componentId The ID of the component type.
+         * @return The size of one component in bytes.
+         */
+        static size_t Size(size_t componentId)
+        {
+            return OperationList[componentId].size;
+        }
+
+        /**
+         * @brief Retrieves the required alignment of a specific component type.
+         *
+         * @param componentId The ID of the component type.
+         * @return The alignment of one component in bytes.
+         */
+        static size_t Alignment(size_t componentId)
+        {
+            return OperationList[componentId].alignment;
+        }
+
+        /**
+         * @brief Checks whether a specific component type is trivially copyable.
+         *
+         * @details
+         * Columns of trivially copyable components are moved with memcpy and their unused slots
+         * hold no live objects: such components are default constructed when a row is reserved
+         * instead of when a row is vacated or a column is grown.
+         *
+         * @param componentId The ID of the component type.
+         * @return true if the component type is trivially copyable.
+         */
+        static bool IsTrivial(size_t componentId)
+        {
+            return OperationList[componentId].trivial;
+        }
+
+        /**
+         * @brief Registers the hooks of a specific component type.
+         *
+         * @param componentId The ID of the component type.
+         * @param hook The hook to call, an empty hook unregisters the current one.
+         * @param removed true to register the hook for removals instead of additions.
+         */
+        static void SetHook(size_t componentId, Hook hook, bool removed)
+        {
+            (removed ? OperationList[componentId].onRemove : OperationList[componentId].onAdd) = hook;
+
+            BinaryId& mask = removed ? RemoveHookMask : AddHookMask;
+            mask = hook.invoke ? (mask | BinaryId::Bit(componentId)) : (mask & ~BinaryId::Bit(componentId));
+        }
+
+        /**
+         * @brief Retrieves a hook of a specific component type.
+         *
+         * @param componentId The ID of the component type.
+         * @param removed true for the removal hook, false for the addition hook.
+         * @return The registered hook, empty if there is none.
+         */
+        static const Hook& GetHook(size_t componentId, bool removed)
         {
-            return OperationList[componentId].ResizeArray(ptrToArray, newSize, moveCount);
+            return removed ? OperationList[componentId].onRemove : OperationList[componentId].onAdd;
         }
 
     };
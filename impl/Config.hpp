@@ -0,0 +1,331 @@
+#pragma once
+
+/**
+ * @file Config.hpp
+ * @brief Compile-time configuration for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file gathers the preprocessor settings used to tailor SECS to a given
+ * target. Every setting has a default suited for memory-constrained consoles
+ * and can be overridden by defining the macro before including secs.hpp
+ * (or on the compiler command line).
+ *
+ * @par Example:
+ * ```cpp
+ * #define SECS_ARCHETYPE_LOOKUP_SIZE 512
+ * #include <secs.hpp>
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ */
+
+/**
+ * @def SECS_ARCHETYPE_LOOKUP_SIZE
+ * @brief Number of slots in the fixed-size archetype lookup table
+ *
+ * @details
+ * Archetypes are resolved from their component binary identifier through an
+ * open-addressing hash table with this many slots. The table is embedded in
+ * every world (2 bytes per slot with 16-bit indices) and must be a power of
+ * two. Keeping it at least twice the number of expected archetypes keeps
+ * probe sequences short; once the table is full, additional archetypes are
+ * still found through a linear scan.
+ */
+#ifndef SECS_ARCHETYPE_LOOKUP_SIZE
+#define SECS_ARCHETYPE_LOOKUP_SIZE 256
+#endif
+
+static_assert((SECS_ARCHETYPE_LOOKUP_SIZE & (SECS_ARCHETYPE_LOOKUP_SIZE - 1)) == 0,
+    "SECS_ARCHETYPE_LOOKUP_SIZE must be a power of two");
+
+/**
+ * @def SECS_CHUNK_SIZE
+ * @brief Size in bytes of the storage chunks used by archetypes, 0 selects contiguous storage
+ *
+ * @details
+ * By default (0) every component column of an archetype is a single contiguous
+ * array that is reallocated and moved when the archetype grows. When set to a
+ * non-zero value, archetypes instead allocate fixed-size chunks, each holding
+ * the same power-of-two number of rows for every column (Structure of Arrays
+ * within the chunk). Growing an archetype then costs a single chunk allocation,
+ * existing rows never move and component pointers stay stable across inserts.
+ *
+ * A typical value is 16384. If one row does not fit, chunks hold a single row.
+ */
+#ifndef SECS_CHUNK_SIZE
+#define SECS_CHUNK_SIZE 0
+#endif
+
+/**
+ * @def SECS_ALLOCATOR
+ * @brief Type providing every allocation made by SECS
+ *
+ * @details
+ * Must name a type with static `void* Allocate(size_t size, size_t alignment)`
+ * and `void Deallocate(void* ptr, size_t size)` functions. Allocate returns
+ * nullptr on failure. Defaults to SECS::DefaultAllocator (malloc/free), see
+ * Allocator.hpp for SECS::ArenaAllocator, a static bump allocator.
+ */
+#ifndef SECS_ALLOCATOR
+#define SECS_ALLOCATOR ::SECS::DefaultAllocator
+#endif
+
+/**
+ * @def SECS_OUT_OF_MEMORY
+ * @brief Handler called when an internal container cannot allocate
+ *
+ * @details
+ * Entity and component storage report allocation failures through return
+ * values, but internal bookkeeping containers (archetype list, transition
+ * edges, query caches) have no way to. When the allocator runs out while
+ * growing one of them, this handler is called instead of handing a null
+ * block to the container. It must not return: the default aborts, builds
+ * with exceptions may throw std::bad_alloc, and abort() is called if the
+ * handler returns anyway.
+ */
+#ifndef SECS_OUT_OF_MEMORY
+#define SECS_OUT_OF_MEMORY() ::abort()
+#endif
+
+/**
+ * @def SECS_EXECUTOR
+ * @brief Type running the jobs of World::IterateParallel
+ *
+ * @details
+ * Must name a type with a static
+ * `void Run(size_t jobCount, void (*job)(void* context, size_t jobIndex), void* context)`
+ * function returning once every job has completed. Defaults to
+ * SECS::SerialExecutor, which runs the jobs on the calling thread, see
+ * Executor.hpp.
+ */
+#ifndef SECS_EXECUTOR
+#define SECS_EXECUTOR ::SECS::SerialExecutor
+#endif
+
+/**
+ * @def SECS_JOB_ROWS
+ * @brief Maximum number of rows processed by one job of World::IterateParallel
+ *
+ * @details
+ * Archetypes larger than this are split into several jobs. Smaller values
+ * balance the load better across workers, larger ones reduce the dispatch
+ * overhead per row.
+ */
+#ifndef SECS_JOB_ROWS
+#define SECS_JOB_ROWS 1024
+#endif
+
+static_assert(SECS_JOB_ROWS > 0, "SECS_JOB_ROWS must be greater than zero");
+
+/**
+ * @def SECS_FUSED_ROWS
+ * @brief Number of rows processed by every lambda of World::EntityIterator::IterateFused in turn
+ *
+ * @details
+ * Each lambda runs over a block of this many rows before the next lambda runs
+ * over the same block, so the block should fit in the data cache together
+ * with the columns the lambdas touch. The default keeps a block of three
+ * 8-byte columns within 2 KB, half the cache of the SH-2.
+ */
+#ifndef SECS_FUSED_ROWS
+#define SECS_FUSED_ROWS 64
+#endif
+
+static_assert(SECS_FUSED_ROWS > 0, "SECS_FUSED_ROWS must be greater than zero");
+
+/**
+ * @def SECS_ORDER_CREATION
+ * @brief SECS_ARCHETYPE_ORDER value visiting archetypes in creation order
+ */
+#define SECS_ORDER_CREATION 0
+
+/**
+ * @def SECS_ORDER_SIZE
+ * @brief SECS_ARCHETYPE_ORDER value visiting the most populated archetypes first
+ */
+#define SECS_ORDER_SIZE 1
+
+/**
+ * @def SECS_ORDER_ADDRESS
+ * @brief SECS_ARCHETYPE_ORDER value visiting archetypes by ascending storage address
+ */
+#define SECS_ORDER_ADDRESS 2
+
+/**
+ * @def SECS_ARCHETYPE_ORDER
+ * @brief Order in which iterations visit the matched archetypes
+ *
+ * @details
+ * Iterations only visit matched archetypes that hold entities. That view is
+ * rebuilt when an archetype becomes empty or non-empty, or when its storage
+ * moves, and is then sorted according to this setting:
+ * - SECS_ORDER_CREATION (default): creation order of the archetypes
+ * - SECS_ORDER_SIZE: largest archetypes first, sizes as of the last rebuild
+ * - SECS_ORDER_ADDRESS: ascending address of the archetype storage, so memory
+ *   is walked forward, which helps hardware prefetchers
+ */
+#ifndef SECS_ARCHETYPE_ORDER
+#define SECS_ARCHETYPE_ORDER SECS_ORDER_CREATION
+#endif
+
+/**
+ * @def SECS_HANDLE_INDEX_BITS
+ * @brief Number of bits of an EntityHandle holding the entity record index
+ *
+ * @details
+ * EntityHandle packs a record index and a generation into 32 bits. The
+ * remaining 32 - SECS_HANDLE_INDEX_BITS bits hold the low bits of the record
+ * version: fewer generation bits allow more entities, but make it likelier
+ * that a handle kept across many reuses of the same record aliases a newer
+ * entity.
+ */
+#ifndef SECS_HANDLE_INDEX_BITS
+#define SECS_HANDLE_INDEX_BITS 16
+#endif
+
+static_assert(SECS_HANDLE_INDEX_BITS > 0 && SECS_HANDLE_INDEX_BITS < 32,
+    "SECS_HANDLE_INDEX_BITS must be between 1 and 31");
+
+/**
+ * @def SECS_COMPONENT_WORDS
+ * @brief Number of machine words in a component binary identifier
+ *
+ * @details
+ * Each component type takes one bit of Component::BinaryId, so a program can
+ * define up to SECS_COMPONENT_WORDS * sizeof(size_t) * CHAR_BIT component
+ * types (32 per word on 32-bit targets, 64 on PC). Every archetype stores
+ * three identifiers, and matching costs one operation per word.
+ */
+#ifndef SECS_COMPONENT_WORDS
+#define SECS_COMPONENT_WORDS 1
+#endif
+
+static_assert(SECS_COMPONENT_WORDS > 0, "SECS_COMPONENT_WORDS must be at least 1");
+
+/**
+ * @def SECS_CHANGE_BLOCK_ROWS
+ * @brief Number of consecutive rows sharing one change tick
+ *
+ * @details
+ * Columns of components opted into change detection with SECS::TrackChanges
+ * record the last tick they were written at once per block of rows. Changed<>
+ * query filters skip whole blocks, so smaller blocks skip more precisely at
+ * the cost of 4 bytes per block and tracked column. Must be a power of two.
+ */
+#ifndef SECS_CHANGE_BLOCK_ROWS
+#define SECS_CHANGE_BLOCK_ROWS 64
+#endif
+
+static_assert(SECS_CHANGE_BLOCK_ROWS > 0 && (SECS_CHANGE_BLOCK_ROWS & (SECS_CHANGE_BLOCK_ROWS - 1)) == 0,
+    "SECS_CHANGE_BLOCK_ROWS must be a power of two");
+
+/**
+ * @def SECS_INDEX_BITS
+ * @brief Width in bits of the Index type
+ *
+ * @details
+ * Index numbers entity records, archetype rows and archetypes, and is stored
+ * three times in every entity record. The default of 16 bits keeps records at
+ * 6 bytes but limits each of these counts to 65535. Set it to 32 (or 64) for
+ * worlds that need more entities; growth past the limit fails gracefully like
+ * an allocation failure.
+ */
+#ifndef SECS_INDEX_BITS
+#define SECS_INDEX_BITS 16
+#endif
+
+static_assert(SECS_INDEX_BITS == 16 || SECS_INDEX_BITS == 32 || SECS_INDEX_BITS == 64,
+    "SECS_INDEX_BITS must be 16, 32 or 64");
+
+/**
+ * @def SECS_THREAD_LOCAL
+ * @brief Storage class of the pointers selecting the current world
+ *
+ * @details
+ * Static World functions operate on the world made current on the calling
+ * thread, see World::MakeCurrent(). With the default of thread_local, threads
+ * can each run their own world. Single-threaded targets can define it empty,
+ * so that resolving the current world is a plain global load.
+ */
+#ifndef SECS_THREAD_LOCAL
+#define SECS_THREAD_LOCAL thread_local
+#endif
+
+/**
+ * @def SECS_ENABLE_STATS
+ * @brief Enables the statistics counters of every world
+ *
+ * @details
+ * When non-zero, worlds count storage growths, the bytes moved by them, entity
+ * moves and row removals, and every query records the rows and archetypes it
+ * visits along with the time its iterations take, see Stats.hpp. With the
+ * default of 0 the counters and every instruction updating them are compiled
+ * out.
+ */
+#ifndef SECS_ENABLE_STATS
+#define SECS_ENABLE_STATS 0
+#endif
+
+/**
+ * @def SECS_STATS_CLOCK
+ * @brief Type reading the time measured by query timers and SECS::ScopedTimer
+ *
+ * @details
+ * Must name a type with a static `uint64_t Now()` function returning a
+ * monotonic tick count, such as a free running hardware timer. Defaults to
+ * SECS::SteadyClock, which counts nanoseconds of std::chrono::steady_clock.
+ * Only used when SECS_ENABLE_STATS is non-zero.
+ */
+#ifndef SECS_STATS_CLOCK
+#define SECS_STATS_CLOCK ::SECS::SteadyClock
+#endif
+
+/**
+ * @def SECS_COMPACT_IDLE_FRAMES
+ * @brief Number of World::AutoCompact() calls an archetype must stay empty for before its storage is released
+ *
+ * @details
+ * Archetypes emptied for a moment, such as between two waves of the same
+ * enemies, keep their storage until they stayed empty this long. Set it to 0
+ * to never release the storage of empty archetypes automatically.
+ */
+#ifndef SECS_COMPACT_IDLE_FRAMES
+#define SECS_COMPACT_IDLE_FRAMES 120
+#endif
+
+/**
+ * @def SECS_COMPACT_LOW_WATER
+ * @brief Occupancy ratio below which World::AutoCompact() shrinks storage
+ *
+ * @details
+ * Archetypes holding entities in less than 1 / SECS_COMPACT_LOW_WATER of
+ * their rows, and a record table using less than that share of its records,
+ * are shrunk to twice their use. The headroom keeps a shrunk archetype from
+ * growing again right away. Set it to 0 to only release empty archetypes.
+ */
+#ifndef SECS_COMPACT_LOW_WATER
+#define SECS_COMPACT_LOW_WATER 4
+#endif
+
+static_assert(SECS_COMPACT_LOW_WATER == 0 || SECS_COMPACT_LOW_WATER >= 2,
+    "SECS_COMPACT_LOW_WATER must be 0 or at least 2, shrunk storage is twice its use");
+
+/**
+ * @def SECS_SPARSE_PAGE_SIZE
+ * @brief Number of entity records covered by one page of a sparse set
+ *
+ * @details
+ * Sparse sets of components opted into SECS::SparseStorage map entity records
+ * to their values through pages allocated on first use, so that a set only
+ * pays for the record ranges it holds entities from. Must be a power of two.
+ */
+#ifndef SECS_SPARSE_PAGE_SIZE
+#define SECS_SPARSE_PAGE_SIZE 256
+#endif
+
+static_assert(SECS_SPARSE_PAGE_SIZE > 0 && (SECS_SPARSE_PAGE_SIZE & (SECS_SPARSE_PAGE_SIZE - 1)) == 0,
+    "SECS_SPARSE_PAGE_SIZE must be a power of two");
@@ -0,0 +1,124 @@
+#pragma once
+
+/**
+ * @file EntityHandle.hpp
+ * @brief Packed 32-bit entity handles for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the EntityHandle class, a compact alternative to
+ * EntityReference for storing entity identities. A handle packs the entity
+ * record index and the low bits of the record version into a single 32-bit
+ * word, so it fits in one register on 32-bit targets such as the SH-2, can be
+ * compared with one instruction and stored in components or network packets
+ * as a plain integer.
+ *
+ * The split between index and generation bits is set with
+ * SECS_HANDLE_INDEX_BITS.
+ *
+ * @par Example:
+ * ```cpp
+ * EntityHandle target(World::CreateEntity<Position>());
+ *
+ * // Later, turn the handle back into a reference to use the entity
+ * target.Get().Access([](Position* pos) { pos->x = 0.0f; });
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see EntityReference For the full entity interface
+ * @see Config.hpp For SECS_HANDLE_INDEX_BITS
+ */
+
+#include <stdint.h>
+
+#include "EntityReference.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Entity identity packed into 32 bits
+     *
+     * @details
+     * The low SECS_HANDLE_INDEX_BITS bits hold the entity record index and the
+     * high bits hold the low bits of the record version. Get() validates the
+     * generation against the current record and returns an empty
+     * EntityReference if the entity was destroyed.
+     *
+     * Entities whose record index does not fit in the index bits cannot be
+     * represented, converting them yields an invalid handle.
+     */
+    class EntityHandle
+    {
+    public:
+        static constexpr uint32_t IndexBits = SECS_HANDLE_INDEX_BITS;           /**< Bits holding the record index. */
+        static constexpr uint32_t GenerationBits = 32 - IndexBits;              /**< Bits holding the record version. */
+        static constexpr uint32_t IndexMask = (uint32_t(1) << IndexBits) - 1;   /**< Mask of the index bits. */
+        static constexpr uint32_t GenerationMask = ~uint32_t(0) >> IndexBits;   /**< Mask of the generation, once shifted down. */
+        static constexpr uint32_t Invalid = ~uint32_t(0);                       /**< Value of handles referring to no entity. */
+
+    private:
+        uint32_t value = Invalid;
+
+    public:
+        /**
+         * @brief Default constructor for creating a handle referring to no entity.
+         */
+        EntityHandle() = default;
+
+        /**
+         * @brief Create a handle identifying the entity an EntityReference refers to.
+         * @param entity The reference to pack.
+         */
+        explicit EntityHandle(const EntityReference& entity)
+        {
+            if (entity.recordIndex != InvalidIndex && entity.recordIndex < IndexMask)
+            {
+                value = uint32_t(entity.recordIndex) | ((uint32_t(entity.version) & GenerationMask) << IndexBits);
+            }
+        }
+
+        /**
+         * @brief Rebuild a handle from its packed value.
+         * @param packed A value obtained from Value().
+         * @return The handle.
+         */
+        static EntityHandle FromValue(uint32_t packed)
+        {
+            EntityHandle handle;
+            handle.value = packed;
+            return handle;
+        }
+
+        /**
+         * @brief Get the packed value of the handle.
+         * @return The index and generation bits.
+         */
+        uint32_t Value() const { return value; }
+
+        /**
+         * @brief Resolve the handle into a reference to its entity.
+         * @return A reference to the entity, or an empty EntityReference if the
+         *         entity was destroyed or the handle refers to no entity.
+         */
+        EntityReference Get() const
+        {
+            const uint32_t index = value & IndexMask;
+            if (value == Invalid || index >= EntityRecord::storage->last) { return EntityReference(); }
+
+            const EntityRecord& record = EntityRecord::Get(index);
+            if ((uint32_t(record.version) & GenerationMask) != (value >> IndexBits) || record.archetype == InvalidIndex)
+            {
+                return EntityReference();
+            }
+
+            return EntityReference(record);
+        }
+
+        bool operator==(const EntityHandle& other) const { return value == other.value; }
+        bool operator!=(const EntityHandle& other) const { return value != other.value; }
+    };
+}
@@ -15,9 +15,9 @@
  * patterns suitable for resource-constrained environments.
  * 
  * Key features:
- * - **Memory efficient**: Uses uint16_t indices to minimize memory footprint
+ * - **Memory efficient**: Uses uint16_t indices by default to minimize memory footprint, see SECS_INDEX_BITS
  * - **Version tracking**: Prevents access to destroyed entities
- * - **Free list recycling**: Reuses entity slots to minimize fragmentation
+ * - **Free list recycling**: Reuses entity slots through an intrusive free list, without allocation
  * - **Exception-free**: Safe allocation failure handling for retro platforms
  * - **Cache-friendly**: Contiguous storage for optimal memory access patterns
  * 
@@ -29,9 +29,9 @@
  * essential for real-time gaming applications.
  * 
  * @par Memory Management:
- * - Records are stored in a dynamically growing array
- * - Destroyed entities are recycled via a free list
- * - Growth strategy: capacity = (capacity * 2) - (capacity / 2)
+ * - Records are stored in a dynamically growing array obtained from SECS_ALLOCATOR
+ * - Destroyed entities are recycled via a free list threaded through the released records
+ * - Growth strategy: capacity = (capacity * 2) - (capacity / 2), clamped to IndexLimit
  * - Allocation failures are handled gracefully without exceptions
  * 
  * @par Thread Safety:
@@ -40,13 +40,16 @@
  * 
  * @par Compiler Requirements:
  * - C++17 compatible compiler (GCC 7+, Clang 5+, MSVC 2017+)
- * - Standard library support for std::stack and basic containers
  */
 
 #include <cstdint>
 #include <cstddef>
-#include <vector>
-#include <stack>
+#include <new>
+#include <utility>
+
+#include "Config.hpp"
+#include "Allocator.hpp"
+#include "Stats.hpp"
 
 namespace SECS
 {
@@ -54,11 +57,21 @@ namespace SECS
      * @brief Type alias for entity and component indices
      * 
      * @details
-     * Uses uint16_t to minimize memory usage while supporting up to 65,535
-     * entities. This is sufficient for most retro gaming scenarios while
-     * keeping memory overhead minimal on systems with limited RAM.
+     * Uses uint16_t by default to minimize memory usage while supporting up to
+     * 65,535 entities. This is sufficient for most retro gaming scenarios while
+     * keeping memory overhead minimal on systems with limited RAM. Builds that
+     * need more entities, rows or archetypes select a wider type through
+     * SECS_INDEX_BITS.
      */
+#if SECS_INDEX_BITS == 16
     using Index = uint16_t;
+#elif SECS_INDEX_BITS == 32
+    using Index = uint32_t;
+#elif SECS_INDEX_BITS == 64
+    using Index = uint64_t;
+#else
+#error "SECS_INDEX_BITS must be 16, 32 or 64"
+#endif
     
     /**
      * @brief Sentinel value representing an invalid or uninitialized index
@@ -69,6 +82,16 @@ namespace SECS
      */
     static constexpr Index InvalidIndex = ~(Index(0));
 
+    /**
+     * @brief Number of distinct valid index values
+     * 
+     * @details
+     * Upper bound on the number of entity records, on the rows of one archetype
+     * and on the number of archetypes. Growth beyond it fails like an
+     * allocation failure instead of wrapping around.
+     */
+    static constexpr size_t IndexLimit = size_t(InvalidIndex);
+
     /**
      * @brief Core entity record for tracking entity metadata and lifecycle
      * 
@@ -79,9 +102,9 @@ namespace SECS
      * - Row index: Position within the archetype's component arrays
      * - Version: Incremented on destruction to invalidate old references
      * 
-     * The class uses static storage to maintain a global pool of entity
-     * records, with automatic growth and efficient recycling of destroyed
-     * entity slots.
+     * Every world owns a pool of entity records, with automatic growth and
+     * efficient recycling of destroyed entity slots. The static interface
+     * works on the pool of the world current on the calling thread.
      * 
      * @par Memory Layout:
      * Records are stored in a contiguous array for cache efficiency.
@@ -93,6 +116,7 @@ namespace SECS
      *     uint16_t version;    // 2 bytes
      * };                      // Total: 6 bytes per entity
      * ```
+     * Wider SECS_INDEX_BITS settings scale the three fields accordingly.
      * 
      * @par Lifecycle Management:
      * 1. **Creation**: Reserve() allocates a new record or reuses a freed one
@@ -128,11 +152,132 @@ namespace SECS
         friend class EntityReference;
         friend class World;
         friend class ArchetypeManager;
+        friend class CommandBuffer;
+        friend class EntityHandle;
+        friend class Snapshot;
+        template <typename...> friend class View;
+
+        /**
+         * @brief The records array of one world and its free list
+         */
+        struct Storage
+        {
+            EntityRecord* records = nullptr;
+            size_t capacity = 0;
+            size_t last = 0;
+            size_t issued = 0;               // Records ever handed out, they keep the versions guarding stale references
+            Index freeHead = InvalidIndex;   // Most recently released record, its row links to the next one
+            size_t freeCount = 0;            // Number of records in the free list
+#if SECS_ENABLE_STATS
+            StorageStats stats;              // Growths of the record table, see World::GetStats()
+#endif
+        };
 
-        static inline size_t capacity = 0;
-        static inline size_t last = 0;
-        static inline std::stack<size_t> freeList;  // Free list for recycling indices
-        static inline EntityRecord* records = nullptr;
+        static Storage defaultStorage;                  /**< Records of the default world. */
+        static SECS_THREAD_LOCAL Storage* storage;      /**< Records of the world current on this thread. */
+
+        /**
+         * @brief Get a record of the current world by index
+         * @param index The index of the record, lower than Storage::issued.
+         *              Every reference holds such an index, even once its entity is destroyed.
+         * @return Reference to the record
+         */
+        static EntityRecord& Get(size_t index) { return storage->records[index]; }
+
+        /**
+         * @brief Expand the records array to a given capacity
+         * 
+         * @param newCapacity The number of records the array must be able to hold.
+         * @return true if the array holds at least newCapacity records, false if allocation failed
+         *         (the array is left untouched).
+         */
+        static bool Grow(size_t newCapacity)
+        {
+            Storage& s = *storage;
+            if (newCapacity <= s.capacity) { return true; }
+            if (newCapacity > IndexLimit) { return false; }
+
+            EntityRecord* newArray = Memory::Allocate<EntityRecord>(newCapacity);
+            if (!newArray) { return false; }
+
+            // Move existing records to the new array
+            for (size_t i = 0; i < s.capacity; ++i) {
+                new (&newArray[i]) EntityRecord(std::move(s.records[i]));
+            }
+
+            for (size_t i = s.capacity; i < newCapacity; ++i) {
+                new (&newArray[i]) EntityRecord();
+            }
+
+#if SECS_ENABLE_STATS
+            s.stats.recordGrowths++;
+            s.stats.bytesMoved += sizeof(EntityRecord) * s.capacity;
+#endif
+
+            Memory::Deallocate(s.records, s.capacity);
+            s.records = newArray;
+            s.capacity = newCapacity;
+            return true;
+        }
+
+        /**
+         * @brief Release the part of the records array that was never handed out
+         * 
+         * @details
+         * Every record below Storage::issued is kept, including the free ones
+         * past Storage::last: references to destroyed entities still index them,
+         * and their versions are what makes those references fail. The array
+         * can therefore never shrink below the largest number of records held
+         * at once, destroying entities alone does not make it reclaimable.
+         * 
+         * @param newCapacity The number of records to keep, raised to Storage::issued if lower.
+         * @return true if the array holds no more than that many records, false if allocation
+         *         failed (the array is left untouched).
+         */
+        static bool Shrink(size_t newCapacity)
+        {
+            Storage& s = *storage;
+            newCapacity = (newCapacity < s.issued) ? s.issued : newCapacity;
+            if (newCapacity >= s.capacity) { return true; }
+
+            EntityRecord* newArray = nullptr;
+            if (newCapacity)
+            {
+                newArray = Memory::Allocate<EntityRecord>(newCapacity);
+                if (!newArray) { return false; }
+
+                for (size_t i = 0; i < newCapacity; ++i) {
+                    new (&newArray[i]) EntityRecord(std::move(s.records[i]));
+                }
+            }
+
+#if SECS_ENABLE_STATS
+            s.stats.bytesMoved += sizeof(EntityRecord) * newCapacity;
+#endif
+
+            Memory::Deallocate(s.records, s.capacity);
+            s.records = newArray;
+            s.capacity = newCapacity;
+            return true;
+        }
+
+        /**
+         * @brief Make sure a number of records can be reserved without growing the array
+         * 
+         * @details
+         * Recycled records from the free list are taken into account, so only the
+         * missing part is allocated, in a single step.
+         * 
+         * @param count The number of records that will be reserved.
+         * @return true if count records can be reserved without allocation, false if allocation failed.
+         * 
+         * @see World::Reserve() For user-facing pre-allocation
+         */
+        static bool ReserveCapacity(size_t count)
+        {
+            const Storage& s = *storage;
+            return (count <= s.freeCount) || (count - s.freeCount <= IndexLimit - s.last && Grow(s.last + (count - s.freeCount)));
+        }
 
         /**
          * @brief Reserves an entity record for a new entity
@@ -147,6 +292,8 @@ namespace SECS
          * The growth strategy uses a modified doubling approach:
          * `new_capacity = (old_capacity * 2) - (old_capacity / 2)`
          * This provides ~1.5x growth to balance memory usage and allocation frequency.
+         * The capacity is clamped to IndexLimit, once every index is in use
+         * the reservation fails like an allocation failure.
          * 
          * @return Reference to a valid EntityRecord ready for initialization
          * @retval EntityRecord& Valid record when allocation succeeds
@@ -160,15 +307,13 @@ namespace SECS
          * @par Performance Notes:
          * - O(1) when reusing from free list
          * - O(n) when expanding array (rare, amortized O(1))
-         * - Memory usage: 6 bytes per entity record
+         * - Memory usage: 6 bytes per entity record with the default 16-bit Index
          * 
          * @par Saturn Optimization:
          * For Saturn development, consider pre-allocating a fixed pool:
          * ```cpp
          * // Pre-allocate for 1000 entities at startup
-         * for (int i = 0; i < 1000; ++i) {
-         *     EntityRecord::Reserve().Release();
-         * }
+         * EntityRecord::ReserveCapacity(1000);
          * ```
          * 
          * @warning This method is for internal ECS use only.
@@ -179,48 +324,60 @@ namespace SECS
          */
         static EntityRecord& Reserve()
         {
+            Storage& s = *storage;
             size_t index;
-            if (!freeList.empty()) {
+            if (s.freeHead != InvalidIndex) {
                 // Reuse an index from the free list
-                index = freeList.top();
-                freeList.pop();
+                index = s.freeHead;
+                s.freeHead = s.records[index].row;
+                s.freeCount--;
             } else {
                 // No free indices, need to expand storage if necessary
-                if (last >= capacity) {
-                    size_t originalCapacity = capacity;
-                    capacity = (capacity == 0) ? 2 : (capacity * 2) - (capacity / 2);
+                if (s.last >= s.capacity) {
+                    // Every representable index is in use
+                    if (s.last >= IndexLimit) { return InvalidRecord(); }
 
-                    EntityRecord* newArray = new EntityRecord[capacity];
-                    if (!newArray) {
+                    // Computed without doubling first so that the growth cannot wrap around
+                    size_t newCapacity = (s.capacity == 0) ? 2 : s.capacity + (s.capacity - s.capacity / 2);
+                    newCapacity = (newCapacity > IndexLimit) ? IndexLimit : newCapacity;
+                    if (!Grow(newCapacity)) {
                         // Handle allocation failure - return invalid record for Saturn compatibility
                         // In production, consider pre-allocating a fixed pool
-                        capacity = originalCapacity; // Restore original capacity
-                        static EntityRecord invalidRecord;
-                        invalidRecord.archetype = InvalidIndex;
-                        invalidRecord.row = InvalidIndex;
-                        invalidRecord.version = InvalidIndex;
-                        return invalidRecord;
-                    }
-
-                    // Move existing records to the new array
-                    for (Index i = 0; i < originalCapacity; ++i) {
-                        newArray[i] = std::move(records[i]);
+                        return InvalidRecord();
                     }
-
-                    delete[] records;
-                    records = newArray;
                 }
                 
-                // Use the next available index
-                index = last++;
+                // Use the next available index, a record past last that was issued
+                // before still holds the version it was released with
+                index = s.last++;
+                s.issued = (s.last > s.issued) ? s.last : s.issued;
             }
-            return records[index];
+            return s.records[index];
         }
 
         Index archetype = InvalidIndex;
         Index row = InvalidIndex;
         Index version = 0;
 
+        /**
+         * @brief Placeholder record returned by Reserve() when storage cannot be allocated
+         * @return Reference to the shared invalid record
+         */
+        static EntityRecord& InvalidRecord()
+        {
+            static EntityRecord invalidRecord;
+            invalidRecord.archetype = InvalidIndex;
+            invalidRecord.row = InvalidIndex;
+            invalidRecord.version = InvalidIndex;
+            return invalidRecord;
+        }
+
+        /**
+         * @brief Check whether this record is a real entry of the records array
+         * @return false for the placeholder returned by a failed Reserve(), true otherwise
+         */
+        bool IsValid() const { return this != &InvalidRecord(); }
+
         /**
          * @brief Calculate this record's index within the global records array
          * 
@@ -249,7 +406,7 @@ namespace SECS
          * @see EntityReference For entity identification usage
          * @see Reserve() For record allocation details
          */
-        Index GetIndex() const { return static_cast<Index>(this - records); }
+        Index GetIndex() const { return static_cast<Index>(this - storage->records); }
 
         /**
          * @brief Release this entity record and make it available for reuse
@@ -273,14 +430,15 @@ namespace SECS
          * entries. This keeps memory usage minimal and improves cache locality.
          * 
          * @par Free List Management:
-         * Records not at the end of the array are added to a free list (stack)
-         * for O(1) reuse during future entity creation. This minimizes memory
-         * fragmentation and provides predictable allocation performance.
+         * Records not at the end of the array are pushed on a free list for O(1)
+         * reuse during future entity creation. The list is intrusive: a released
+         * record stores the index of the next free record in its `row` field, so
+         * releasing and reusing records never allocates.
          * 
          * @par Performance Characteristics:
          * - O(1) for most releases
          * - O(k) when optimizing trailing free entries (k = consecutive free entries)
-         * - Memory overhead: One stack entry per fragmented free record
+         * - Memory overhead: None, the free list lives in the released records
          * 
          * @par Example Lifecycle:
          * ```cpp
@@ -311,21 +469,29 @@ namespace SECS
             version++;
 
             // Get the index of this record
-            Index index = GetIndex();
+            Storage& s = *storage;
+            Index index = static_cast<Index>(this - s.records);
             
             // If this is the last record in the array, just decrement last
-            if (index == last - 1) {
-                last--;
+            if (index == s.last - 1) {
+                s.last--;
                 
                 // Also release any indices at the end that are in the free list
-                while (last > 0 && !freeList.empty() && freeList.top() == last - 1) {
-                    freeList.pop();
-                    last--;
+                while (s.last > 0 && s.freeHead == s.last - 1) {
+                    s.freeHead = s.records[s.freeHead].row;
+                    s.freeCount--;
+                    s.last--;
                 }
             } else {
-                // Add the index to the free list for reuse
-                freeList.push(index);
+                // Push the index on the free list, linked through the row field
+                row = s.freeHead;
+                s.freeHead = index;
+                s.freeCount++;
             }
         }
     };
+
+    // Defined out of the class, the member initializers of Storage are only usable once EntityRecord is complete
+    inline EntityRecord::Storage EntityRecord::defaultStorage;
+    inline SECS_THREAD_LOCAL EntityRecord::Storage* EntityRecord::storage = &EntityRecord::defaultStorage;
 }
@@ -16,7 +16,7 @@
  * Key features:
  * - **Automatic validation**: Access attempts return false for invalid entities
  * - **Version tracking**: Prevents access to destroyed entities
- * - **Lightweight design**: Only 4 bytes per reference (2x uint16_t)
+ * - **Lightweight design**: Two Index values per reference, 4 bytes with the default SECS_INDEX_BITS
  * - **Exception-free**: All operations use return codes instead of exceptions
  * - **Type-safe access**: Component access validated at compile-time
  * 
@@ -28,8 +28,8 @@
  * 
  * @par Memory Efficiency:
  * Designed for memory-constrained environments like the Sega Saturn:
- * - Uses uint16_t indices (supports up to 65,535 entities)
- * - Minimal memory footprint (4 bytes per reference)
+ * - Uses uint16_t indices by default (supports up to 65,535 entities, see SECS_INDEX_BITS)
+ * - Minimal memory footprint (2 * sizeof(Index) bytes per reference)
  * - No dynamic allocation required
  * - Cache-friendly access patterns
  * 
@@ -64,14 +64,14 @@ namespace SECS
      * @par Key Features:
      * - **Automatic validation**: Access attempts return false for invalid entities
      * - **Version tracking**: Prevents access to destroyed entities
-     * - **Lightweight**: Only 4 bytes (2x uint16_t) per reference
+     * - **Lightweight**: Two Index values per reference, 4 bytes with the default SECS_INDEX_BITS
      * - **Exception-free**: All operations use return codes instead of exceptions
      * - **Type-safe access**: Component access is validated at compile-time
      * 
      * @par Memory Efficiency:
      * EntityReference is designed for memory-constrained environments:
-     * - Uses uint16_t for indices (supports up to 65,535 entities)
-     * - Minimal memory footprint (4 bytes per reference)
+     * - Uses uint16_t for indices by default (supports up to 65,535 entities, see SECS_INDEX_BITS)
+     * - Minimal memory footprint (2 * sizeof(Index) bytes per reference)
      * - No dynamic allocation
      * - Cache-friendly access patterns
      * 
@@ -85,6 +85,11 @@ namespace SECS
      * EntityReference is NOT thread-safe. External synchronization is required
      * for concurrent access from multiple threads.
      * 
+     * @par Worlds:
+     * A reference is resolved in the world current on the calling thread, see
+     * World::MakeCurrent(). It must only be used while the world it was
+     * created in is current.
+     * 
      * @par Usage Examples:
      * @code{.cpp}
      * // Create entity and get reference
@@ -118,6 +123,9 @@ namespace SECS
     {
     private:
         friend class World;
+        friend class CommandBuffer;
+        friend class EntityHandle;
+        template <typename...> friend class View;
 
         Index recordIndex = InvalidIndex;
         Index version = InvalidIndex;
@@ -126,7 +134,94 @@ namespace SECS
          * @brief Private constructor for creating an EntityReference from an EntityRecord.
          * @param record The EntityRecord to reference.
          */
-        EntityReference(const EntityRecord& record) : recordIndex(record.GetIndex()), version(record.version) {}
+        EntityReference(const EntityRecord& record)
+        {
+            if (record.IsValid())
+            {
+                recordIndex = record.GetIndex();
+                version = record.version;
+            }
+        }
+
+        /**
+         * @brief Check that a record still holds the referenced entity.
+         * @details Snapshot::Load() can set a record back to an older version, so a matching
+         * version alone does not mean that the record is in use.
+         * @param record The EntityRecord at recordIndex.
+         * @return true if the record has the version of the reference and is not released.
+         */
+        bool Holds(const EntityRecord& record) const
+        {
+            return version == record.version && record.archetype != InvalidIndex;
+        }
+
+        /**
+         * @brief Run the hooks registered for some components of an entity.
+         * @details The world is locked against structural changes while the hooks run, so the
+         * component pointers they receive stay valid.
+         * @param record The EntityRecord of the entity, the components must be in its archetype.
+         * @param components The binary identifier of the added or removed components.
+         * @param removed true to run the OnRemove hooks, false to run the OnAdd hooks.
+         */
+        static void RunHooks(const EntityRecord& record, Component::BinaryId components, bool removed)
+        {
+            components &= removed ? Component::RemoveHookMask : Component::AddHookMask;
+            if (!components) { return; }
+
+            const EntityReference entity(record);
+            const ArchetypeManager& archetype = ArchetypeManager::Get(record.archetype);
+
+            ArchetypeManager::storage->structuralLocks++;
+            components.ForEach([&entity, &archetype, &record, removed](size_t componentId)
+            {
+                void* component = nullptr;
+                const ArchetypeManager::InternalIndex column = archetype.ColumnIndex(componentId);
+                if (column != ArchetypeManager::Unused)
+                {
+                    component = static_cast<uint8_t*>(archetype.GetColumn(column, record.row)) +
+                        Component::Size(componentId) * archetype.ColumnPosition(record.row);
+                }
+
+                const Component::Hook& hook = Component::GetHook(componentId, removed);
+                hook.invoke(hook.callback, entity, component);
+            });
+            ArchetypeManager::storage->structuralLocks--;
+        }
+
+        /**
+         * @brief Move the referenced entity into the archetype that also has the given components.
+         * @details Unlike Add(), no OnAdd hook is run.
+         * @tparam Ts The component types to add.
+         * @param added Receives the binary identifier of the components the entity did not have yet.
+         * @return true if the entity now has all the given components.
+         */
+        template <typename... Ts>
+        bool AddWithoutHooks(Component::BinaryId& added)
+        {
+            if (recordIndex == InvalidIndex) { return false; }
+
+            EntityRecord& record = EntityRecord::Get(recordIndex);
+            if (!Holds(record) || ArchetypeManager::IsLocked()) { return false; }
+
+            if constexpr (ArchetypeManager::HasSparse<Ts...>)
+            {
+                // Sparse sets are reserved before the row moves, so that inserting into them cannot fail after it
+                if (!(ArchetypeManager::ReserveSparse<Ts>(recordIndex) && ...)) { return false; }
+            }
+
+            const Component::BinaryId columns = ArchetypeManager::ColumnsId<Ts...>();
+            if (columns)
+            {
+                const Index source = record.archetype;
+                Index target = ArchetypeManager::Transition(source, columns, true);
+                if (!ArchetypeManager::MoveEntity(record, target)) { return false; }
+
+                added = ArchetypeManager::Get(target).id & ~ArchetypeManager::Get(source).id;
+            }
+
+            (ArchetypeManager::InsertSparse<Ts>(recordIndex), ...);
+            return true;
+        }
 
     public:
         /**
@@ -154,7 +249,7 @@ namespace SECS
          * 
          * @return bool Returns true if the entity is valid and the lambda was executed
          *              successfully. Returns false if the entity is invalid, destroyed,
-         *              or doesn't have the required components.
+         *              or doesn't have the required components (the lambda is not executed).
          * 
          * @par Performance Notes:
          * - Component types are validated at compile-time
@@ -206,7 +301,8 @@ namespace SECS
          * 
          * @par Best Practices:
          * - Always check the return value for critical operations
-         * - Use const references for read-only access
+         * - Use const references for read-only access, non-const access to components
+         *   opted into change detection marks them as written (see TrackChanges)
          * - Keep lambda bodies lightweight for optimal performance
          * - Avoid capturing large objects in the lambda
          * 
@@ -223,15 +319,159 @@ namespace SECS
             bool status = false;
             if (recordIndex != InvalidIndex)
             {
-                const EntityRecord& record = EntityRecord::records[recordIndex];
-                if (version == record.version)
+                const EntityRecord& record = EntityRecord::Get(recordIndex);
+                if (Holds(record))
                 {
-                    ArchetypeManager& archetype = ArchetypeManager::managers[record.archetype];
+                    ArchetypeManager& archetype = ArchetypeManager::Get(record.archetype);
                     using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
-                    LambdaTraits::CallWithTypes([lambda, &archetype, &record]<typename ...Components>()
+                    status = LambdaTraits::CallWithTypes([lambda, &archetype, &record]<typename ...Components>()
                     {
-                        lambda(archetype.GetComponent<Components>(record.row)...);
+                        if (!archetype.Contains(ArchetypeManager::ColumnsId<Components...>())) { return false; }
+                        if constexpr (ArchetypeManager::HasSparse<Components...>)
+                        {
+                            if (!(ArchetypeManager::HoldsSparse<Components>(record.GetIndex()) && ...)) { return false; }
+                        }
+                        lambda(ArchetypeManager::Fetch<Components>(archetype, record)...);
+                        if constexpr (ArchetypeManager::WritesTracked<Components...>)
+                        {
+                            archetype.MarkChanged(record.row, 1, ArchetypeManager::WrittenId<Components...>());
+                        }
+                        return true;
                     });
+                }
+            }
+            return status;
+        }
+
+        /**
+         * @brief Add components to the referenced entity without recreating it
+         * 
+         * @details
+         * Moves the entity's row into the archetype that also contains the given
+         * component types. Existing component values are moved along, the new
+         * components are left default constructed. The entity keeps its identity,
+         * so every EntityReference to it stays valid.
+         * 
+         * Transitions are cached per archetype, so toggling the same component
+         * repeatedly (e.g. a `Stunned` marker) only costs the row move. Components
+         * opted into SparseStorage are inserted into their sparse set instead and
+         * do not move the row at all.
+         * 
+         * @tparam Ts The component types to add. Types the entity already has are kept as they are.
+         * 
+         * @return bool Returns true if the entity is valid and now has all the
+         *              given components, false if the entity is invalid, destroyed,
+         *              storage for the new archetype row could not be allocated or
+         *              a World::IterateParallel dispatch is in progress.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * entity.Add<Stunned>();
+         * @endcode
+         * 
+         * @see Add(Lambda) For adding and initializing components in one call
+         * @see Remove() For removing components
+         */
+        template <typename... Ts>
+        bool Add()
+        {
+            Component::BinaryId added;
+            if (!AddWithoutHooks<Ts...>(added)) { return false; }
+
+            RunHooks(EntityRecord::Get(recordIndex), added, false);
+            return true;
+        }
+
+        /**
+         * @brief Add components to the referenced entity and initialize them through a lambda function
+         * 
+         * @details
+         * Same as Add<Ts...>() with the component types deduced from the lambda
+         * signature. After the move the lambda receives pointers to the entity's
+         * components, the same way World::CreateEntity(Lambda) does. OnAdd hooks
+         * run once the lambda has initialized the components.
+         * 
+         * @param lambda A callable object taking pointers to the component types to add.
+         * 
+         * @return bool Returns true if the components were added and the lambda was executed,
+         *              false if the entity is invalid or destroyed.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * entity.Add([](Stunned* stunned) {
+         *     stunned->frames = 30;
+         * });
+         * @endcode
+         * 
+         * @see Add() For adding components without initialization
+         * @see Remove() For removing components
+         */
+        template <typename Lambda>
+        bool Add(Lambda lambda)
+        {
+            using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+            return LambdaTraits::CallWithTypes([this, &lambda]<typename ...Ts>()
+            {
+                Component::BinaryId added;
+                if (!AddWithoutHooks<Ts...>(added)) { return false; }
+                const EntityRecord& record = EntityRecord::Get(recordIndex);
+                ArchetypeManager& archetype = ArchetypeManager::Get(record.archetype);
+                lambda(ArchetypeManager::Fetch<Ts>(archetype, record)...);
+                RunHooks(record, added, false);
+                return true;
+            });
+        }
+
+        /**
+         * @brief Remove components from the referenced entity without recreating it
+         * 
+         * @details
+         * Moves the entity's row into the archetype lacking the given component
+         * types. The remaining component values are moved along and the entity
+         * keeps its identity. Like Add(), transitions are cached per archetype.
+         * Sparse components are erased from their sparse set without moving the row.
+         * 
+         * @tparam Ts The component types to remove. Types the entity does not have are ignored.
+         * 
+         * @return bool Returns true if the entity is valid and no longer has the given
+         *              components, false if the entity is invalid, destroyed, storage
+         *              for the new archetype row could not be allocated or a
+         *              World::IterateParallel dispatch is in progress.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * entity.Remove<Stunned>();
+         * @endcode
+         * 
+         * @see Add() For adding components
+         */
+        template <typename... Ts>
+        bool Remove()
+        {
+            bool status = false;
+            if (recordIndex != InvalidIndex)
+            {
+                EntityRecord& record = EntityRecord::Get(recordIndex);
+                if (Holds(record) && !ArchetypeManager::IsLocked())
+                {
+                    const Component::BinaryId columns = ArchetypeManager::ColumnsId<Ts...>();
+                    if (columns)
+                    {
+                        Index target = ArchetypeManager::Transition(record.archetype, columns, false);
+                        ArchetypeManager& targetManager = ArchetypeManager::Get(target);
+                        const Component::BinaryId removed = ArchetypeManager::Get(record.archetype).id & ~targetManager.id;
+
+                        // Hooks see the components before they go, so the move must not fail after them
+                        if (removed & Component::RemoveHookMask)
+                        {
+                            if (!targetManager.Grow(size_t(targetManager.size) + 1)) { return false; }
+                            RunHooks(record, removed, true);
+                        }
+
+                        if (!ArchetypeManager::MoveEntity(record, target)) { return false; }
+                    }
+
+                    (ArchetypeManager::EraseSparse<Ts>(recordIndex), ...);
                     status = true;
                 }
             }
@@ -262,6 +502,7 @@ namespace SECS
          * @par Safety Guarantees:
          * - Safe to call multiple times (subsequent calls are no-ops)
          * - Safe to call on invalid entities (no effect)
+         * - No effect during a World::IterateParallel dispatch, the reference stays valid
          * - No exceptions thrown under any circumstances
          * - Automatic invalidation of all references to this entity
          * 
@@ -308,13 +549,14 @@ namespace SECS
          */
         void Destroy()
         {
-            if (recordIndex != InvalidIndex)
+            if (recordIndex != InvalidIndex && !ArchetypeManager::IsLocked())
             {
-                const EntityRecord& record = EntityRecord::records[recordIndex];
+                const EntityRecord& record = EntityRecord::Get(recordIndex);
                 recordIndex = InvalidIndex;
-                if (version == record.version)
+                if (Holds(record))
                 {
-                    ArchetypeManager::managers[record.archetype].RemoveRow(record.row);
+                    RunHooks(record, ArchetypeManager::Get(record.archetype).id, true);
+                    ArchetypeManager::Get(record.archetype).RemoveRow(record.row);
                 }
             }
         }
@@ -0,0 +1,88 @@
+#pragma once
+
+/**
+ * @file Executor.hpp
+ * @brief Job dispatch hook for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * World::IterateParallel splits its work into independent jobs and hands them
+ * to the executor type selected by SECS_EXECUTOR. SECS does not create threads
+ * itself: the executor decides where the jobs run, which lets the library plug
+ * into an existing job system or stay single-threaded on targets without one.
+ *
+ * An executor is a type exposing one static function, which must return only
+ * once every job has completed:
+ * ```cpp
+ * struct MyExecutor
+ * {
+ *     static void Run(size_t jobCount, void (*job)(void* context, size_t jobIndex), void* context);
+ * };
+ *
+ * #define SECS_EXECUTOR MyExecutor
+ * #include <secs.hpp>
+ * ```
+ *
+ * @par Example:
+ * A minimal executor on top of std::thread:
+ * ```cpp
+ * struct ThreadExecutor
+ * {
+ *     static void Run(size_t jobCount, void (*job)(void*, size_t), void* context)
+ *     {
+ *         std::atomic<size_t> next = 0;
+ *         auto worker = [&] {
+ *             for (size_t i = next++; i < jobCount; i = next++) job(context, i);
+ *         };
+ *
+ *         const unsigned cores = std::thread::hardware_concurrency();
+ *         std::vector<std::thread> threads(cores > 1 ? cores - 1 : 0);
+ *         for (auto& thread : threads) thread = std::thread(worker);
+ *         worker();
+ *         for (auto& thread : threads) thread.join();
+ *     }
+ * };
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see Config.hpp For SECS_EXECUTOR and SECS_JOB_ROWS
+ */
+
+#include <stddef.h>
+
+#include "Config.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Executor used when SECS_EXECUTOR is not defined
+     *
+     * @details
+     * Runs every job in order on the calling thread.
+     */
+    struct SerialExecutor
+    {
+        /**
+         * @brief Runs a set of jobs and waits for their completion.
+         * @param jobCount The number of jobs.
+         * @param job The function to call once per job index.
+         * @param context The context pointer passed to every job.
+         */
+        static void Run(size_t jobCount, void (*job)(void* context, size_t jobIndex), void* context)
+        {
+            for (size_t i = 0; i < jobCount; ++i)
+            {
+                job(context, i);
+            }
+        }
+    };
+
+    /**
+     * @brief The executor selected through SECS_EXECUTOR.
+     */
+    using Executor = SECS_EXECUTOR;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * @file Hierarchy.hpp
+ * @brief Parent links between entities for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the ChildOf component linking an entity to its parent.
+ * World::SetParent() maintains the links and the depth of every linked entity,
+ * and keeps the rows of each archetype sorted by depth, with siblings next to
+ * each other. EntityIterator::IterateHierarchy() then visits every parent
+ * before its children in one linear pass per depth, which propagates values
+ * such as world transforms down a scene graph without recursive lookups.
+ *
+ * @par Example:
+ * ```cpp
+ * World::SetParent(turret, tank);
+ *
+ * World::EntityIterator it;
+ * it.IterateHierarchy([](const Transform* parent, const LocalTransform* local, Transform* world) {
+ *     *world = parent ? Combine(*parent, *local) : Transform(*local);
+ * });
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see World::SetParent() For linking entities
+ * @see World::EntityIterator::IterateHierarchy() For propagating values down the hierarchy
+ */
+
+#include "EntityReference.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Link of an entity to its parent
+     *
+     * @details
+     * Added by World::SetParent() and removed by World::ClearParent(). Adding
+     * it any other way, for instance through EntityReference::Add() or a
+     * prefab, links the entity as well, World::SortHierarchy() computes its
+     * depth. The component can be read like any other but existing links
+     * should not be written directly, changing their parent is not detected.
+     *
+     * Destroying a parent leaves its children linked to an invalid reference,
+     * they are then treated as roots.
+     */
+    struct ChildOf
+    {
+        EntityReference parent;     /**< The parent entity. */
+        Index depth = 0;            /**< Number of valid ancestors, computed by World::SortHierarchy(). */
+    };
+}
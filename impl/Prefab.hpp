@@ -0,0 +1,160 @@
+#pragma once
+
+/**
+ * @file Prefab.hpp
+ * @brief Entity templates for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the Prefab class, a stored row of component values that
+ * World::Instantiate() copies into freshly reserved rows. Setting up an entity
+ * once and cloning it replaces running a creation lambda with a dozen field
+ * assignments per entity, which matters at high spawn rates such as bullets
+ * and particles.
+ *
+ * @par Example:
+ * ```cpp
+ * const Prefab<Position, Velocity, Bullet> bullet([](Position* pos, Velocity* vel) {
+ *     pos->x = 160.0f; pos->y = 200.0f;
+ *     vel->dx = 0.0f; vel->dy = -4.0f;
+ * });
+ *
+ * World::Instantiate(bullet, 32);
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see World::Instantiate() For creating entities from a prefab
+ */
+
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+
+#include "Archetype.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Component values cloned into every entity created from it
+     *
+     * @details
+     * A prefab holds one value of each component type of an archetype. Order
+     * and const qualifiers of Ts do not matter, prefabs listing the same types
+     * instantiate into the same archetype. Tags take no memory in entities,
+     * only their presence is copied.
+     *
+     * Trivially copyable components are copied bytewise, doubling the copied
+     * range with each memcpy; other components are copy assigned.
+     *
+     * @tparam Ts The component types of the entities created from the prefab.
+     */
+    template <typename... Ts>
+    class Prefab
+    {
+        friend struct World;
+
+        static_assert((ComponentType<std::remove_cv_t<Ts>> && ...), "Prefab components must be object types");
+        static_assert(((std::is_copy_constructible_v<std::remove_cv_t<Ts>> && std::is_copy_assignable_v<std::remove_cv_t<Ts>>) && ...),
+            "Prefab components must be copyable");
+
+        std::tuple<std::remove_cv_t<Ts>...> values;
+
+        /**
+         * @brief Copy the value of a component into a span of consecutive rows.
+         * @tparam T The component type.
+         * @param destination The component of the first row. For trivially copyable components
+         *                    the storage is uninitialized, otherwise it holds live objects.
+         * @param count The number of rows.
+         */
+        template <typename T>
+        void Fill(T* destination, size_t count) const
+        {
+            using Type = std::remove_cv_t<T>;
+            const Type& value = std::get<Type>(values);
+
+            if constexpr (std::is_empty_v<Type>)
+            {
+                (void)destination;
+                (void)count;
+            }
+            else if constexpr (std::is_trivially_copyable_v<Type>)
+            {
+                if (!count) { return; }
+
+                memcpy(destination, &value, sizeof(Type));
+                for (size_t filled = 1; filled < count;)
+                {
+                    const size_t copied = (filled < count - filled) ? filled : count - filled;
+                    memcpy(destination + filled, destination, sizeof(Type) * copied);
+                    filled += copied;
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    destination[i] = value;
+                }
+            }
+        }
+
+    public:
+        /**
+         * @brief Default constructor for creating a prefab of value initialized components.
+         */
+        Prefab() = default;
+
+        /**
+         * @brief Create a prefab with components initialized through a lambda function.
+         * @details The lambda receives pointers to value initialized components, in the same way
+         * as World::CreateEntity(Lambda). It may take any subset of Ts.
+         * @param lambda A callable object taking pointers to some of the component types.
+         */
+        template <typename Lambda>
+        explicit Prefab(Lambda lambda)
+        {
+            Access(lambda);
+        }
+
+        /**
+         * @brief Change the stored components through a lambda function.
+         * @details Entities already created from the prefab are not affected.
+         * @param lambda A callable object taking pointers to some of the component types.
+         */
+        template <typename Lambda>
+        void Access(Lambda lambda)
+        {
+            using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+            LambdaTraits::CallWithTypes([this, &lambda]<typename... Components>()
+            {
+                lambda(Get<Components>()...);
+            });
+        }
+
+        /**
+         * @brief Get a stored component.
+         * @tparam T The component type, one of Ts.
+         * @return A pointer to the stored component.
+         */
+        template <typename T>
+        T* Get()
+        {
+            return &std::get<std::remove_cv_t<T>>(values);
+        }
+
+        /**
+         * @brief Get a stored component.
+         * @tparam T The component type, one of Ts.
+         * @return A pointer to the stored component.
+         */
+        template <typename T>
+        const T* Get() const
+        {
+            return &std::get<std::remove_cv_t<T>>(values);
+        }
+    };
+}
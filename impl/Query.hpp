@@ -0,0 +1,246 @@
+#pragma once
+
+/**
+ * @file Query.hpp
+ * @brief Query filters for entity iteration in the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the filter types refining which entities an iteration
+ * visits beyond the components taken by the lambda. Filters are resolved on
+ * archetype binary identifiers when the query cache is updated, so archetypes
+ * they exclude are never visited at all. Components opted into SparseStorage
+ * are not part of archetypes, With and Without terms naming them are checked
+ * on each row instead.
+ *
+ * - **With<Ts...>**: Entities must also have Ts, which are not passed to the lambda
+ * - **Without<Ts...>**: Entities must have none of Ts
+ * - **Optional<Ts...>**: Lambda parameters of types Ts may be nullptr, entities
+ *   lacking them are still visited
+ * - **Changed<Ts...>**: Entities must have Ts, and only blocks of rows where
+ *   any of Ts was written since the previous iteration are visited
+ *
+ * @par Example:
+ * ```cpp
+ * World::EntityIterator it;
+ * it.Iterate<Without<Dead>, Optional<Sprite>>([](Position* pos, Sprite* sprite) {
+ *     if (sprite) DrawSprite(sprite->id, pos->x, pos->y);
+ * });
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see World::EntityIterator For the iterations accepting filters
+ */
+
+#include <type_traits>
+
+#include "Archetype.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Common base of the query filters, contributing nothing to the query.
+     */
+    struct QueryFilterBase
+    {
+        static Component::BinaryId WithId() { return {}; }
+        static Component::BinaryId WithoutId() { return {}; }
+        static Component::BinaryId OptionalId() { return {}; }
+        static Component::BinaryId ChangedId() { return {}; }
+
+        template <typename T>
+        static constexpr bool IsOptional = false;
+
+        static constexpr bool IsChanged = false;
+        static constexpr bool HasSparse = false;
+
+        static bool MatchesSparse(Index) { return true; }
+        static void KeepSmallerSparse(const SparseSet*&) {}
+        static void PrepareSparse() {}
+    };
+
+    /**
+     * @brief Query filter requiring components that are not passed to the lambda.
+     * @tparam Ts The component types entities must have.
+     */
+    template <typename... Ts>
+    struct With : QueryFilterBase
+    {
+        static Component::BinaryId WithId() { return ArchetypeManager::ColumnsId<Ts...>(); }
+
+        static constexpr bool HasSparse = ArchetypeManager::HasSparse<Ts...>;
+
+        static bool MatchesSparse(Index record) { return (ArchetypeManager::HoldsSparse<Ts>(record) && ...); }
+        static void KeepSmallerSparse(const SparseSet*& smallest) { (ArchetypeManager::KeepSmallerSparse<Ts>(smallest), ...); }
+        static void PrepareSparse() { (ArchetypeManager::PrepareSparse<Ts>(), ...); }
+    };
+
+    /**
+     * @brief Query filter excluding entities that have any of the given components.
+     * @tparam Ts The component types entities must not have.
+     */
+    template <typename... Ts>
+    struct Without : QueryFilterBase
+    {
+        static Component::BinaryId WithoutId() { return ArchetypeManager::ColumnsId<Ts...>(); }
+
+        static constexpr bool HasSparse = ArchetypeManager::HasSparse<Ts...>;
+
+        static bool MatchesSparse(Index record) { return (ArchetypeManager::LacksSparse<Ts>(record) && ...); }
+        static void PrepareSparse() { (ArchetypeManager::PrepareSparse<Ts>(), ...); }
+    };
+
+    /**
+     * @brief Query filter making lambda components optional.
+     * @details The lambda receives nullptr for these components on entities lacking them.
+     * @tparam Ts The component types that may be missing.
+     */
+    template <typename... Ts>
+    struct Optional : QueryFilterBase
+    {
+        static Component::BinaryId OptionalId() { return ArchetypeManager::ColumnsId<Ts...>(); }
+
+        template <typename T>
+        static constexpr bool IsOptional = (std::is_same_v<std::remove_cv_t<T>, std::remove_cv_t<Ts>> || ...);
+    };
+
+    /**
+     * @brief Query filter visiting only entities whose components were written recently.
+     *
+     * @details
+     * Entities must have Ts, which are not passed to the lambda unless also taken as parameters.
+     * Writes are tracked per block of SECS_CHANGE_BLOCK_ROWS rows: a written block is visited whole,
+     * blocks where none of Ts was written since the iterator's previous Changed<> iteration are
+     * skipped. The components must be opted into change detection through TrackChanges.
+     *
+     * @tparam Ts The component types whose changes are looked for.
+     */
+    template <typename... Ts>
+    struct Changed : QueryFilterBase
+    {
+        static_assert((TrackChanges<std::remove_cv_t<Ts>>::value && ...),
+            "Changed<> requires components opted into change detection through SECS::TrackChanges");
+
+        static Component::BinaryId WithId() { return ArchetypeManager::Helper<Ts...>::id; }
+        static Component::BinaryId ChangedId() { return ArchetypeManager::Helper<Ts...>::id; }
+
+        static constexpr bool IsChanged = true;
+    };
+
+    /**
+     * @brief Combination of the filters of a query.
+     * @tparam Filters The With, Without and Optional filters of the query.
+     */
+    template <typename... Filters>
+    struct QueryFilter
+    {
+        static_assert((std::is_base_of_v<QueryFilterBase, Filters> && ...),
+            "Query filters must be With<...>, Without<...>, Optional<...> or Changed<...>");
+
+        /**
+         * @brief Get the components entities must have aside from those passed to the lambda.
+         * @return The binary identifier of the required components.
+         */
+        static Component::BinaryId WithId() { return (Component::BinaryId() | ... | Filters::WithId()); }
+
+        /**
+         * @brief Get the components entities must not have.
+         * @return The binary identifier of the excluded components.
+         */
+        static Component::BinaryId WithoutId() { return (Component::BinaryId() | ... | Filters::WithoutId()); }
+
+        /**
+         * @brief Get the lambda components entities may lack.
+         * @return The binary identifier of the optional components.
+         */
+        static Component::BinaryId OptionalId() { return (Component::BinaryId() | ... | Filters::OptionalId()); }
+
+        /**
+         * @brief Get the components whose changes select the visited blocks of rows.
+         * @return The binary identifier of the changed components looked for.
+         */
+        static Component::BinaryId ChangedId() { return (Component::BinaryId() | ... | Filters::ChangedId()); }
+
+        static constexpr bool HasChanged = (false || ... || Filters::IsChanged);
+        static constexpr bool HasSparse = (false || ... || Filters::HasSparse);
+
+        /**
+         * @brief Check the sparse components named by With and Without filters on one entity.
+         * @param record The entity record index.
+         * @return true if the entity holds every sparse With component and no sparse Without component.
+         */
+        static bool MatchesSparse(Index record)
+        {
+            (void)record;
+            return (true && ... && Filters::MatchesSparse(record));
+        }
+
+        /**
+         * @brief Replace a sparse set by the smallest one of the sparse With components.
+         * @param smallest The smallest sparse set so far, or nullptr.
+         */
+        static void KeepSmallerSparse(const SparseSet*& smallest)
+        {
+            (void)smallest;
+            (Filters::KeepSmallerSparse(smallest), ...);
+        }
+
+        /**
+         * @brief Create the sparse sets named by With and Without filters in the current world.
+         */
+        static void PrepareSparse() { (Filters::PrepareSparse(), ...); }
+
+        /**
+         * @brief Get the components entities must have to be visited by the query.
+         * @param components The binary identifier of the components taken by the lambda.
+         * @return The binary identifier of the required components.
+         */
+        static Component::BinaryId Required(Component::BinaryId components)
+        {
+            return (components & ~OptionalId()) | WithId();
+        }
+
+        /**
+         * @brief Check whether an archetype matches the query.
+         * @param archetype The binary identifier of the archetype.
+         * @param components The binary identifier of the components taken by the lambda.
+         * @return true if entities of the archetype are visited by the query.
+         */
+        static bool Matches(Component::BinaryId archetype, Component::BinaryId components)
+        {
+            return archetype.Contains(Required(components)) && !archetype.Intersects(WithoutId());
+        }
+
+        template <typename T>
+        static constexpr bool IsOptional = (false || ... || Filters::template IsOptional<T>);
+
+        /**
+         * @brief Advance a component pointer to the next row.
+         * @details Optional components missing from the archetype stay nullptr, tags keep pointing to
+         * their shared instance.
+         * @tparam T The component type.
+         * @param component The pointer to the component of the current row.
+         * @return The pointer to the component of the next row.
+         */
+        template <typename T>
+        static T* Next(T* component)
+        {
+            if constexpr (std::is_empty_v<T>)
+            {
+                return component;
+            }
+            else if constexpr (IsOptional<T>)
+            {
+                return component ? component + 1 : component;
+            }
+            else
+            {
+                return component + 1;
+            }
+        }
+    };
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+/**
+ * @file Schedule.hpp
+ * @brief Compile-time scheduling of systems for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the Schedule class, which runs a fixed list of systems
+ * once per call to Run(). The read and write sets of every system are deduced
+ * at compile time from its lambda signature: pointers to const components are
+ * reads, all other component parameters are writes. Two systems conflict when
+ * one writes a component the other reads or writes.
+ *
+ * Systems are grouped into stages at compile time. A system goes into the
+ * stage following the last stage holding an earlier system it conflicts with,
+ * so conflicting systems always run in declaration order and systems of one
+ * stage never conflict. The grouping is fixed by the declaration order alone,
+ * which keeps the results of a frame deterministic no matter how many workers
+ * run it.
+ *
+ * Each stage is a single dispatch to the executor selected by SECS_EXECUTOR.
+ * Its jobs are ranges of at most SECS_JOB_ROWS rows of one archetype, and each
+ * job runs every system of the stage matching the archetype on its rows, one
+ * block of SECS_FUSED_ROWS rows after the other, as
+ * World::EntityIterator::IterateFused() does. Systems touching the same
+ * columns therefore share one pass over them while the rows are still in
+ * cache. No locking happens during the dispatch, the stage layout already
+ * rules out concurrent conflicting access.
+ *
+ * @par Example:
+ * ```cpp
+ * auto move = [](Position* pos, const Velocity* vel) { pos->x += vel->dx; pos->y += vel->dy; };
+ * auto spin = [](Rotation* rot, const Spin* spin) { rot->angle += spin->speed; };
+ * auto draw = [](const Position* pos, const Rotation* rot) { DrawSprite(pos->x, pos->y, rot->angle); };
+ *
+ * // move and spin share stage 0, draw reads what both write and runs in stage 1
+ * Schedule frame(move, spin, draw);
+ * static_assert(decltype(frame)::StageCount == 2);
+ *
+ * frame.Run();
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see World::AccessOf() For the runtime form of the access sets
+ * @see Executor.hpp For plugging in a job system
+ */
+
+#include <array>
+#include <stdint.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "World.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Type-level access of a system, deduced from its lambda signature.
+     * @tparam Method The type of the lambda's call operator.
+     */
+    template <typename Method>
+    struct SystemAccess;
+
+    /**
+     * @brief Specialization of SystemAccess for per-entity lambdas.
+     * @tparam ReturnType The return type of the lambda.
+     * @tparam ClassType The lambda closure type.
+     * @tparam Types The pointed-to component types of the parameters.
+     */
+    template <class ReturnType, class ClassType, typename... Types>
+    struct SystemAccess<ReturnType(ClassType::*)(Types* ...) const>
+    {
+        /**
+         * @brief Whether the system reads or writes a component.
+         * @tparam T The component type, qualifiers are ignored.
+         */
+        template <typename T>
+        static constexpr bool Touches = (false || ... || std::is_same_v<std::remove_cv_t<T>, std::remove_cv_t<Types>>);
+
+        /**
+         * @brief Whether the system writes a component another system touches.
+         * @tparam Other The SystemAccess of the other system.
+         */
+        template <typename Other>
+        static constexpr bool WritesInto = (false || ... || (!std::is_const_v<Types> && Other::template Touches<Types>));
+
+        /**
+         * @brief Whether the system may not run concurrently with another one.
+         * @tparam Other The SystemAccess of the other system.
+         */
+        template <typename Other>
+        static constexpr bool ConflictsWith = WritesInto<Other> || Other::template WritesInto<SystemAccess>;
+    };
+
+    /**
+     * @brief Fixed list of systems run in conflict-free stages
+     *
+     * @details
+     * Every system is a lambda taking pointers to component types, as passed to
+     * World::EntityIterator::Iterate(). Systems receive no query filters and are
+     * called concurrently from several workers when the executor runs jobs in
+     * parallel, captured state they modify must be synchronized by the caller.
+     *
+     * During Run() the current world is locked against structural changes, like
+     * during World::IterateParallel(). Record such changes in a CommandBuffer per
+     * worker and flush them after the call.
+     *
+     * @tparam Systems The lambda types of the systems, in declaration order.
+     */
+    template <typename... Systems>
+    class Schedule
+    {
+        static_assert(sizeof...(Systems) > 0, "A schedule needs at least one system");
+        static_assert(sizeof...(Systems) <= 32, "A schedule holds at most 32 systems");
+
+    public:
+        static constexpr size_t SystemCount = sizeof...(Systems);   /**< Number of systems of the schedule. */
+
+    private:
+        using SystemMask = uint32_t;
+
+        template <size_t I>
+        using System = std::tuple_element_t<I, std::tuple<Systems...>>;
+
+        template <size_t I>
+        using Access = SystemAccess<decltype(&System<I>::operator())>;
+
+        /**
+         * @brief Build the table of conflicting pairs of systems.
+         * @return The table, entry `a * SystemCount + b` is true if systems a and b conflict.
+         */
+        template <size_t... Pairs>
+        static constexpr std::array<bool, SystemCount * SystemCount> ConflictTable(std::index_sequence<Pairs...>)
+        {
+            std::array<bool, SystemCount * SystemCount> table{};
+            ((table[Pairs] = Access<Pairs / SystemCount>::template ConflictsWith<Access<Pairs % SystemCount>>), ...);
+            return table;
+        }
+
+        static constexpr std::array<bool, SystemCount * SystemCount> conflicts =
+            ConflictTable(std::make_index_sequence<SystemCount * SystemCount>());
+
+        /**
+         * @brief Place every system in the stage after the last earlier system it conflicts with.
+         * @return The stage of each system.
+         */
+        static constexpr std::array<size_t, SystemCount> StageTable()
+        {
+            std::array<size_t, SystemCount> table{};
+            for (size_t system = 0; system < SystemCount; ++system)
+            {
+                for (size_t earlier = 0; earlier < system; ++earlier)
+                {
+                    if (conflicts[system * SystemCount + earlier] && table[earlier] + 1 > table[system])
+                    {
+                        table[system] = table[earlier] + 1;
+                    }
+                }
+            }
+            return table;
+        }
+
+        static constexpr std::array<size_t, SystemCount> stages = StageTable();
+
+        /**
+         * @brief Count the stages of the schedule.
+         * @return One more than the highest stage of a system.
+         */
+        static constexpr size_t CountStages()
+        {
+            size_t count = 0;
+            for (size_t stage : stages)
+            {
+                count = (stage + 1 > count) ? stage + 1 : count;
+            }
+            return count;
+        }
+
+    public:
+        static constexpr size_t StageCount = CountStages();         /**< Number of dispatches of each Run(). */
+
+        /**
+         * @brief Check whether two systems may not run concurrently.
+         * @param a The index of the first system.
+         * @param b The index of the second system.
+         * @return true if either system writes a component the other one reads or writes.
+         */
+        static constexpr bool Conflicts(size_t a, size_t b)
+        {
+            return conflicts[a * SystemCount + b];
+        }
+
+        /**
+         * @brief Get the stage a system runs in.
+         * @param system The index of the system in declaration order.
+         * @return The stage, stages run in increasing order.
+         */
+        static constexpr size_t StageOf(size_t system)
+        {
+            return stages[system];
+        }
+
+    private:
+        std::tuple<Systems...> systems;
+
+        /**
+         * @brief Mark the archetypes matched by a system of a stage and its writes to tracked components.
+         * @tparam I The index of the system.
+         * @param stage The stage being dispatched.
+         * @param matched The systems matching each archetype, indexed by archetype.
+         */
+        template <size_t I>
+        static void Match(size_t stage, Vector<SystemMask>& matched)
+        {
+            if (stages[I] != stage) { return; }
+
+            using LambdaTraits = LambdaUtil<decltype(&System<I>::operator())>;
+            LambdaTraits::CallWithTypes([&matched]<typename... Components>()
+            {
+                static_assert(!ArchetypeManager::HasSparse<Components...>,
+                    "Schedule systems are run over columns, sparse components cannot be parameters, see SECS::SparseStorage");
+                using LookupCache = ArchetypeManager::LookupCache<Components...>;
+                const Vector<Index>& active = LookupCache::Update();
+                LookupCache::CountIteration();
+                for (Index managerIndex : active)
+                {
+                    matched[managerIndex] |= SystemMask(1) << I;
+                    World::MarkDispatched<Components...>(ArchetypeManager::Get(managerIndex));
+                    LookupCache::CountVisited(ArchetypeManager::Get(managerIndex).size);
+                }
+            });
+        }
+
+        /**
+         * @brief Run a system on a block of rows.
+         * @tparam I The index of the system.
+         * @param manager The archetype holding the rows.
+         * @param begin The first row of the block.
+         * @param end One past the last row of the block.
+         */
+        template <size_t I>
+        void RunSystem(ArchetypeManager& manager, Index begin, Index end) const
+        {
+            const System<I>& system = std::get<I>(systems);
+            using LambdaTraits = LambdaUtil<decltype(&System<I>::operator())>;
+            LambdaTraits::CallWithTypes([&system, &manager, begin, end]<typename... Components>()
+            {
+                static_assert(!ArchetypeManager::HasSparse<Components...>,
+                    "Schedule systems are run over columns, sparse components cannot be parameters, see SECS::SparseStorage");
+                manager.EachSpan(begin, end, [&system, &manager](Index first, Index count)
+                {
+                    [&system, count](Components* ...componentArray)
+                    {
+                        for (Index i = 0; i < count; ++i)
+                        {
+                            system(componentArray...);
+                            ((componentArray = QueryFilter<>::Next(componentArray)), ...);
+                        }
+                    }(manager.template GetComponent<Components>(first) ...);
+                });
+            });
+        }
+
+        /**
+         * @brief Run the systems of one job of a stage dispatch on its rows.
+         * @param schedule The schedule being run.
+         * @param job The job.
+         */
+        static void RunJob(const Schedule& schedule, const ArchetypeManager::Job& job)
+        {
+            for (size_t begin = job.begin; begin < job.end; begin += SECS_FUSED_ROWS)
+            {
+                const size_t end = (begin + SECS_FUSED_ROWS < job.end) ? begin + SECS_FUSED_ROWS : job.end;
+                [&]<size_t... I>(std::index_sequence<I...>)
+                {
+                    ((job.systems & (SystemMask(1) << I) ? schedule.RunSystem<I>(*job.manager, Index(begin), Index(end)) : void()), ...);
+                }(std::make_index_sequence<SystemCount>());
+            }
+        }
+
+    public:
+        /**
+         * @brief Create a schedule running the given systems.
+         * @param systems The systems, in the order conflicting systems must run.
+         */
+        explicit Schedule(Systems... systems) : systems(std::move(systems)...) {}
+
+        /**
+         * @brief Run every system once over the entities of the current world.
+         * @details Stages are dispatched one after the other, each one returns once all its jobs
+         * have completed. Within a job, systems run in declaration order. The matched archetypes
+         * and the jobs are kept in storage owned by the world, like World::IterateParallel() does,
+         * so running a schedule every frame does not allocate. For the same reason, a schedule
+         * cannot run while the world is locked, from the jobs of a dispatch or from a hook.
+         * @return true if the systems ran, false without running any if the world is locked.
+         */
+        bool Run() const
+        {
+            if (ArchetypeManager::IsLocked()) { return false; }
+
+            Vector<SystemMask>& matched = ArchetypeManager::storage->jobSystems;
+
+            for (size_t stage = 0; stage < StageCount; ++stage)
+            {
+                matched.assign(ArchetypeManager::storage->managers.size(), 0);
+                [&]<size_t... I>(std::index_sequence<I...>)
+                {
+                    (Match<I>(stage, matched), ...);
+                }(std::make_index_sequence<SystemCount>());
+
+                const Vector<ArchetypeManager::Job>& jobs = World::SplitJobs([&matched](auto&& split)
+                {
+                    for (size_t managerIndex = 0; managerIndex < matched.size(); ++managerIndex)
+                    {
+                        if (matched[managerIndex]) { split(ArchetypeManager::Get(managerIndex), matched[managerIndex]); }
+                    }
+                });
+                World::Dispatch<const Schedule, &RunJob>(*this, jobs);
+            }
+            return true;
+        }
+    };
+}
@@ -0,0 +1,500 @@
+#pragma once
+
+/**
+ * @file Snapshot.hpp
+ * @brief Binary snapshots of a whole world for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the Snapshot class, which saves the entity records and
+ * every archetype of the current world into a flat binary image and restores
+ * a world from such an image. The image holds the raw bytes of each column,
+ * so saving and loading cost a few memcpy calls per archetype and never call
+ * back into component code, which makes them cheap enough for per-frame
+ * rollback and turns level loading into a single read of the image.
+ *
+ * @par Image Layout:
+ * ```
+ * ImageHeader
+ * EntityRecord records[recordCount]
+ * For each archetype holding entities:
+ *     ArchetypeHeader
+ *     uint32_t columnSizes[columns]
+ *     Index recordIndices[rows]
+ *     column data, rows * size bytes per column, in component ID order
+ * ```
+ * Values are stored in native byte order without padding. Images are tied to
+ * the program that saved them: component IDs and sizes, the Index width and
+ * the binary identifier width are checked when loading.
+ *
+ * @par Limitations:
+ * Only trivially copyable components can be saved, worlds holding entities
+ * with other components cannot be snapshotted, nor can worlds where entities
+ * hold sparse components. Resources, hooks and query results are not part of
+ * the image.
+ *
+ * @par Example:
+ * ```cpp
+ * static uint8_t rollback[32 * 1024];
+ * size_t used = Snapshot::Save(rollback, sizeof(rollback));
+ *
+ * // Later, rewind the world
+ * Snapshot::Load(rollback, used);
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see World::MakeCurrent() For selecting the world to save or load
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include "World.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Saves and restores the current world as a binary image
+     *
+     * @details
+     * Save() writes the entity records and the rows of every archetype as they
+     * are laid out in memory. Load() replaces the content of the current world
+     * with the image: existing entities are dropped without running hooks,
+     * and entity references saved along with the image are valid again after
+     * loading it, since record indices and versions are restored as well.
+     *
+     * References taken after the save fail once the image is loaded. When the
+     * image holds an entity in the same record, the record gets back the saved
+     * version, older than the one of such a reference. Once the restored
+     * entity is destroyed and the record reused, its version climbs back, and
+     * the reference reaches the unrelated entity created there. Drop such
+     * references when rewinding the world.
+     *
+     * Loading validates the whole image and allocates all the storage it needs
+     * before touching the world, so a truncated, corrupted or foreign image, or
+     * an allocation failure, leaves the entities of the world untouched.
+     *
+     * Rows restored by Load() count as written for change detection.
+     *
+     * Components opted into SparseStorage are not part of images: Save() fails
+     * while any entity holds one, and Load() removes them from every entity.
+     */
+    class Snapshot
+    {
+        static constexpr uint32_t Magic = 0x53454353;   /**< "SECS" in ASCII. */
+        static constexpr uint16_t FormatVersion = 1;    /**< Bumped whenever the image layout changes. */
+
+        static_assert(std::is_trivially_copyable_v<EntityRecord>, "Entity records are saved as raw bytes");
+
+        /**
+         * @brief Leading block of an image.
+         */
+        struct ImageHeader
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t idBytes;           /**< Size of a component binary identifier. */
+            uint32_t indexBytes;        /**< Size of an Index. */
+            uint32_t archetypeCount;    /**< Number of archetype blocks following the records. */
+            uint64_t recordCount;       /**< Number of records in use, i.e. Storage::last. */
+            uint64_t freeHead;
+            uint64_t freeCount;
+        };
+
+        /**
+         * @brief Leading block of the rows of one archetype.
+         */
+        struct ArchetypeHeader
+        {
+            Component::BinaryId id;
+            uint64_t index;             /**< Index of the archetype in the saved world, referred to by the records. */
+            uint64_t rows;
+        };
+
+        /**
+         * @brief An archetype block of an image, validated by Load().
+         */
+        struct Block
+        {
+            Component::BinaryId id;
+            size_t index;
+            size_t rows;
+            const uint8_t* data;        /**< Record indices, followed by the column data. */
+            Index target = InvalidIndex;    /**< The archetype of the current world receiving the rows. */
+        };
+
+        /**
+         * @brief Sequential writer into a bounded buffer.
+         * @details Without buffer, only counts the bytes that would be written.
+         */
+        struct Writer
+        {
+            uint8_t* buffer;
+            size_t capacity;
+            size_t used = 0;
+            bool overflow = false;
+
+            void Write(const void* data, size_t bytes)
+            {
+                if (buffer && !overflow)
+                {
+                    overflow = bytes > capacity - used;
+                    if (!overflow && bytes) { memcpy(buffer + used, data, bytes); }
+                }
+                used += bytes;
+            }
+        };
+
+        /**
+         * @brief Sequential reader over a bounded image.
+         */
+        struct Reader
+        {
+            const uint8_t* data;
+            size_t size;
+            size_t used = 0;
+
+            const uint8_t* Take(size_t bytes)
+            {
+                if (bytes > size - used) { return nullptr; }
+                const uint8_t* block = data + used;
+                used += bytes;
+                return block;
+            }
+
+            template <typename T>
+            bool Read(T& value)
+            {
+                const uint8_t* block = Take(sizeof(T));
+                if (block) { memcpy(&value, block, sizeof(T)); }
+                return block != nullptr;
+            }
+        };
+
+        /**
+         * @brief Write the image of the current world.
+         * @param buffer The destination, or nullptr to only compute the size of the image.
+         * @param capacity The size of the destination in bytes.
+         * @return The size of the image, or 0 if it cannot be written.
+         */
+        static size_t Encode(uint8_t* buffer, size_t capacity)
+        {
+            if (ArchetypeManager::IsLocked()) { return 0; }
+
+            const EntityRecord::Storage& records = *EntityRecord::storage;
+            Vector<ArchetypeManager>& managers = ArchetypeManager::storage->managers;
+
+            ImageHeader header{ Magic, FormatVersion, sizeof(Component::BinaryId), sizeof(Index), 0,
+                records.last, records.freeHead, records.freeCount };
+            for (const ArchetypeManager& manager : managers)
+            {
+                if (!manager.size) { continue; }
+                if (manager.columnsId != manager.trivialId) { return 0; }
+                header.archetypeCount++;
+            }
+
+            // Sparse sets are not saved, entities must not lose their sparse components silently
+            for (const SparseSet& set : ArchetypeManager::storage->sparseSets)
+            {
+                if (set.Size()) { return 0; }
+            }
+
+            Writer writer{ buffer, capacity };
+            writer.Write(&header, sizeof(header));
+            writer.Write(records.records, sizeof(EntityRecord) * records.last);
+
+            for (size_t index = 0; index < managers.size(); ++index)
+            {
+                ArchetypeManager& manager = managers[index];
+                if (!manager.size) { continue; }
+
+                const ArchetypeHeader archetype{ manager.id, index, manager.size };
+                writer.Write(&archetype, sizeof(archetype));
+
+                for (ArchetypeManager::InternalIndex column = 0; column < manager.columnCount; ++column)
+                {
+                    const uint32_t size = static_cast<uint32_t>(manager.columns[column].size);
+                    writer.Write(&size, sizeof(size));
+                }
+
+                manager.EachSpan([&writer, &manager](Index first, Index count)
+                {
+                    writer.Write(&manager.RecordIndex(first), sizeof(Index) * count);
+                });
+
+                for (ArchetypeManager::InternalIndex column = 0; column < manager.columnCount; ++column)
+                {
+                    const size_t size = manager.columns[column].size;
+                    manager.EachSpan([&writer, &manager, column, size](Index first, Index count)
+                    {
+                        writer.Write(static_cast<uint8_t*>(manager.GetColumn(column, first)) + size * manager.ColumnPosition(first),
+                            size * count);
+                    });
+                }
+            }
+
+            return writer.overflow ? 0 : writer.used;
+        }
+
+        /**
+         * @brief Read and validate the archetype block at the position of a reader.
+         * @param reader The reader positioned on the block, moved past it.
+         * @param recordCount The number of records of the image.
+         * @param block Receives the block.
+         * @return true if the block is well formed and its components match the registered ones.
+         */
+        static bool ReadBlock(Reader& reader, size_t recordCount, Block& block)
+        {
+            ArchetypeHeader archetype;
+            if (!reader.Read(archetype)) { return false; }
+            if (archetype.rows == 0 || archetype.rows > IndexLimit || archetype.index >= IndexLimit) { return false; }
+
+            block.id = archetype.id;
+            block.index = static_cast<size_t>(archetype.index);
+            block.rows = static_cast<size_t>(archetype.rows);
+
+            // Every component must be registered, columns must be trivially copyable and of the saved size
+            bool valid = true;
+            size_t rowBytes = 0;
+            archetype.id.ForEach([&reader, &valid, &rowBytes](size_t componentId)
+            {
+                if (!valid || componentId >= Component::Count()) { valid = false; return; }
+                if (Component::TagMask.Test(componentId)) { return; }
+
+                uint32_t size = 0;
+                valid = reader.Read(size) && size == Component::Size(componentId) && Component::IsTrivial(componentId);
+                rowBytes += size;
+            });
+
+            if (!valid || rowBytes + sizeof(Index) > SIZE_MAX / block.rows) { return false; }
+
+            block.data = reader.Take((rowBytes + sizeof(Index)) * block.rows);
+            if (!block.data) { return false; }
+
+            for (size_t row = 0; row < block.rows; ++row)
+            {
+                Index record;
+                memcpy(&record, block.data + sizeof(Index) * row, sizeof(Index));
+                if (record >= recordCount) { return false; }
+            }
+
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Compute the size of the image of the current world.
+         * @return The number of bytes Save() writes, or 0 if the world holds entities with
+         *         components that are not trivially copyable or with sparse components.
+         */
+        static size_t Size()
+        {
+            return Encode(nullptr, 0);
+        }
+
+        /**
+         * @brief Save the current world into a buffer.
+         * @param buffer The destination of the image.
+         * @param capacity The size of the destination in bytes, see Size().
+         * @return The number of bytes written, or 0 if the buffer is too small, the world holds
+         *         entities with components that are not trivially copyable or with sparse
+         *         components, which are not serialized, or a World::IterateParallel dispatch
+         *         is in progress.
+         */
+        static size_t Save(void* buffer, size_t capacity)
+        {
+            return buffer ? Encode(static_cast<uint8_t*>(buffer), capacity) : 0;
+        }
+
+        /**
+         * @brief Replace the content of the current world with an image written by Save().
+         *
+         * @details
+         * The image is only read during the call, it may be released afterwards. Component
+         * data is copied into the storage of the world, one memcpy per column and span.
+         *
+         * @param image The image.
+         * @param size The size of the image in bytes.
+         * @return true on success, false if the image is invalid or was saved by a different
+         *         build, storage could not be allocated, or a World::IterateParallel dispatch is
+         *         in progress. The entities of the world are left untouched on failure.
+         *
+         * @warning Must not be called while an iteration over the world is in progress.
+         */
+        static bool Load(const void* image, size_t size)
+        {
+            if (!image || ArchetypeManager::IsLocked()) { return false; }
+
+            Reader reader{ static_cast<const uint8_t*>(image), size };
+            ImageHeader header;
+            if (!reader.Read(header) || header.magic != Magic || header.version != FormatVersion ||
+                header.idBytes != sizeof(Component::BinaryId) || header.indexBytes != sizeof(Index))
+            {
+                return false;
+            }
+
+            if (header.recordCount > IndexLimit || header.freeCount > header.recordCount ||
+                (header.freeHead != InvalidIndex && header.freeHead >= header.recordCount))
+            {
+                return false;
+            }
+
+            const size_t recordCount = static_cast<size_t>(header.recordCount);
+            const uint8_t* recordData = reader.Take(sizeof(EntityRecord) * recordCount);
+            if (!recordData) { return false; }
+
+            Vector<Block> blocks;
+            size_t indexCount = 0;
+            for (uint32_t i = 0; i < header.archetypeCount; ++i)
+            {
+                Block block;
+                if (!ReadBlock(reader, recordCount, block)) { return false; }
+                indexCount = (block.index >= indexCount) ? block.index + 1 : indexCount;
+                blocks.push_back(block);
+            }
+
+            // Saved archetype index to block
+            Vector<Index> blockOf(indexCount, InvalidIndex);
+            for (size_t i = 0; i < blocks.size(); ++i)
+            {
+                if (blockOf[blocks[i].index] != InvalidIndex) { return false; }
+                blockOf[blocks[i].index] = static_cast<Index>(i);
+            }
+
+            for (size_t i = 0; i < recordCount; ++i)
+            {
+                EntityRecord record;
+                memcpy(&record, recordData + sizeof(EntityRecord) * i, sizeof(EntityRecord));
+                if (record.archetype == InvalidIndex)
+                {
+                    // Released records link the free list through their row
+                    if (record.row != InvalidIndex && record.row >= recordCount) { return false; }
+                }
+                else if (record.archetype >= indexCount || blockOf[record.archetype] == InvalidIndex ||
+                    record.row >= blocks[blockOf[record.archetype]].rows)
+                {
+                    return false;
+                }
+            }
+
+            // Each row must hold the record pointing to it, so that no two entities share a row
+            for (const Block& block : blocks)
+            {
+                for (size_t row = 0; row < block.rows; ++row)
+                {
+                    Index recordIndex;
+                    memcpy(&recordIndex, block.data + sizeof(Index) * row, sizeof(Index));
+                    EntityRecord record;
+                    memcpy(&record, recordData + sizeof(EntityRecord) * recordIndex, sizeof(EntityRecord));
+                    if (record.archetype != block.index || record.row != row) { return false; }
+                }
+            }
+
+            // The free list must reach its end after freeCount released records, a cycle never does
+            Index free = static_cast<Index>(header.freeHead);
+            for (size_t i = 0; i < header.freeCount; ++i)
+            {
+                if (free == InvalidIndex) { return false; }
+                EntityRecord record;
+                memcpy(&record, recordData + sizeof(EntityRecord) * free, sizeof(EntityRecord));
+                if (record.archetype != InvalidIndex) { return false; }
+                free = record.row;
+            }
+            if (free != InvalidIndex) { return false; }
+
+            // Everything is allocated before the world changes
+            for (size_t i = 0; i < blocks.size(); ++i)
+            {
+                blocks[i].target = static_cast<Index>(ArchetypeManager::Find(blocks[i].id));
+                for (size_t j = 0; j < i; ++j)
+                {
+                    if (blocks[j].target == blocks[i].target) { return false; }
+                }
+
+                if (!ArchetypeManager::Get(blocks[i].target).Grow(blocks[i].rows)) { return false; }
+            }
+
+            if (!EntityRecord::Grow(recordCount)) { return false; }
+
+            for (ArchetypeManager& manager : ArchetypeManager::storage->managers)
+            {
+                manager.Clear();
+            }
+
+            for (SparseSet& set : ArchetypeManager::storage->sparseSets)
+            {
+                if (set.ops) { set.Clear(); }
+            }
+
+            // Records keep the highest of their saved and current versions unless the image holds
+            // an entity in them, so that references taken after the save fail like references
+            // to destroyed entities. Records past the image are released, they are reused with
+            // their versions once the table grows past recordCount again.
+            EntityRecord::Storage& records = *EntityRecord::storage;
+            for (size_t i = 0; i < recordCount; ++i)
+            {
+                EntityRecord& record = records.records[i];
+                EntityRecord saved;
+                memcpy(&saved, recordData + sizeof(EntityRecord) * i, sizeof(EntityRecord));
+                if (saved.archetype != InvalidIndex)
+                {
+                    saved.archetype = blocks[blockOf[saved.archetype]].target;
+                }
+                else
+                {
+                    const Index current = (record.archetype != InvalidIndex) ? static_cast<Index>(record.version + 1) : record.version;
+                    saved.version = (current > saved.version) ? current : saved.version;
+                }
+                record = saved;
+            }
+
+            for (size_t i = recordCount; i < records.issued; ++i)
+            {
+                EntityRecord& record = records.records[i];
+                if (record.archetype != InvalidIndex) { record.version++; }
+                record.archetype = InvalidIndex;
+                record.row = InvalidIndex;
+            }
+
+            records.last = recordCount;
+            records.issued = (recordCount > records.issued) ? recordCount : records.issued;
+            records.freeHead = static_cast<Index>(header.freeHead);
+            records.freeCount = static_cast<size_t>(header.freeCount);
+
+            for (const Block& block : blocks)
+            {
+                ArchetypeManager& manager = ArchetypeManager::Get(block.target);
+                const Index rows = static_cast<Index>(block.rows);
+
+                manager.EachSpan(0, rows, [&manager, &block](Index first, Index count)
+                {
+                    memcpy(&manager.RecordIndex(first), block.data + sizeof(Index) * first, sizeof(Index) * count);
+                });
+
+                const uint8_t* columnData = block.data + sizeof(Index) * block.rows;
+                for (ArchetypeManager::InternalIndex column = 0; column < manager.columnCount; ++column)
+                {
+                    const size_t elementSize = manager.columns[column].size;
+                    manager.EachSpan(0, rows, [&manager, column, elementSize, columnData](Index first, Index count)
+                    {
+                        memcpy(static_cast<uint8_t*>(manager.GetColumn(column, first)) + elementSize * manager.ColumnPosition(first),
+                            columnData + elementSize * first, elementSize * count);
+                    });
+                    columnData += elementSize * block.rows;
+                }
+
+                manager.size = rows;
+                manager.rowsAdded += rows;
+                manager.MarkChanged(0, rows, manager.columnsId);
+            }
+
+            ArchetypeManager::storage->occupancyEpoch++;
+            return true;
+        }
+    };
+}
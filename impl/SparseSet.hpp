@@ -0,0 +1,317 @@
+#pragma once
+
+/**
+ * @file SparseSet.hpp
+ * @brief Paged sparse set storage for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the SparseSet class, the storage of components opted into
+ * SparseStorage. Each set maps entity record indices to a packed array of
+ * values through pages of SECS_SPARSE_PAGE_SIZE entries, allocated the first
+ * time an entity of their range is inserted. Lookups, insertions and removals
+ * are O(1) and never touch the archetype storage of the entity.
+ *
+ * @par Memory Layout:
+ * ```
+ * pages:    [page 0] [nullptr] [page 2] ...   record -> dense index
+ * entities: [record] [record] [record] ...    dense index -> record
+ * values:   [value]  [value]  [value]  ...    dense index -> component
+ * ```
+ * Removals move the last value into the freed slot, keeping values packed.
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see SparseStorage For opting a component type into sparse storage
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Config.hpp"
+#include "Allocator.hpp"
+#include "EntityRecord.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Type-erased paged sparse set of component values
+     *
+     * @details
+     * Sets are plain values owning raw storage, Release() frees it. Insert()
+     * cannot fail once Reserve() succeeded for the same record, which lets
+     * callers reserve every set an operation touches before changing any.
+     */
+    class SparseSet
+    {
+    public:
+        /**
+         * @brief Type-erased operations on the stored component type.
+         */
+        struct Operations
+        {
+            size_t size;
+            size_t alignment;
+            void (*construct)(void* element);
+            void (*destroy)(void* element);
+            void (*relocate)(void* destination, void* source, size_t count);
+        };
+
+        /**
+         * @brief Operations of a component type, tags get a size of 0 and store no values.
+         * @tparam T The component type.
+         */
+        template <typename T>
+        static inline const Operations OperationsOf = {
+            std::is_empty_v<T> ? 0 : sizeof(T),
+            alignof(T),
+            [](void* element) { new (element) T(); },
+            [](void* element) { static_cast<T*>(element)->~T(); },
+            [](void* destination, void* source, size_t count)
+            {
+                T* to = static_cast<T*>(destination);
+                T* from = static_cast<T*>(source);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    new (to + i) T(std::move(from[i]));
+                    from[i].~T();
+                }
+            }
+        };
+
+        const Operations* ops = nullptr;
+
+    private:
+        static constexpr size_t PageSize = SECS_SPARSE_PAGE_SIZE;
+
+        Index** pages = nullptr;
+        size_t pageCount = 0;
+        Index* entities = nullptr;
+        uint8_t* values = nullptr;
+        size_t count = 0;
+        size_t capacity = 0;
+
+        /**
+         * @brief Get the page entry of a record.
+         * @param record The entity record index.
+         * @return A pointer to the entry, or nullptr if its page was never allocated.
+         */
+        Index* Entry(Index record) const
+        {
+            const size_t page = record / PageSize;
+            return (page < pageCount && pages[page]) ? &pages[page][record % PageSize] : nullptr;
+        }
+
+        /**
+         * @brief Grow the packed arrays.
+         * @return True if the capacity was increased.
+         */
+        bool Grow()
+        {
+            if (capacity >= IndexLimit) { return false; }
+
+            size_t newCapacity = capacity ? (capacity * 2) - (capacity / 2) : 8;
+            newCapacity = (newCapacity > IndexLimit) ? IndexLimit : newCapacity;
+
+            Index* newEntities = Memory::Allocate<Index>(newCapacity);
+            if (!newEntities) { return false; }
+
+            if (ops->size)
+            {
+                uint8_t* newValues = static_cast<uint8_t*>(Allocator::Allocate(ops->size * newCapacity, ops->alignment));
+                if (!newValues)
+                {
+                    Memory::Deallocate(newEntities, newCapacity);
+                    return false;
+                }
+
+                if (values)
+                {
+                    ops->relocate(newValues, values, count);
+                    Allocator::Deallocate(values, ops->size * capacity);
+                }
+                values = newValues;
+            }
+
+            if (entities)
+            {
+                memcpy(newEntities, entities, sizeof(Index) * count);
+                Memory::Deallocate(entities, capacity);
+            }
+
+            entities = newEntities;
+            capacity = newCapacity;
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Get the number of entities in the set.
+         * @return The number of entities.
+         */
+        size_t Size() const { return count; }
+
+        /**
+         * @brief Get the record of the entity at a dense index.
+         * @param dense The dense index, below Size().
+         * @return The entity record index.
+         */
+        Index Entity(size_t dense) const { return entities[dense]; }
+
+        /**
+         * @brief Get the dense index of an entity.
+         * @param record The entity record index.
+         * @return The dense index, or InvalidIndex if the entity is not in the set.
+         */
+        Index Find(Index record) const
+        {
+            const Index* entry = Entry(record);
+            return entry ? *entry : InvalidIndex;
+        }
+
+        /**
+         * @brief Get the value at a dense index.
+         * @param dense The dense index, below Size().
+         * @return A pointer to the value, values of tags have no storage.
+         */
+        void* Value(Index dense) const { return values + ops->size * dense; }
+
+        /**
+         * @brief Make sure inserting an entity cannot fail.
+         * @param record The entity record index.
+         * @return True if the page of the record and a free slot are allocated.
+         */
+        bool Reserve(Index record)
+        {
+            const size_t page = record / PageSize;
+
+            if (page >= pageCount)
+            {
+                const size_t newCount = page + 1;
+                Index** newPages = Memory::Reallocate(pages, pageCount, newCount);
+                if (!newPages) { return false; }
+
+                for (size_t i = pageCount; i < newCount; ++i)
+                {
+                    newPages[i] = nullptr;
+                }
+                pages = newPages;
+                pageCount = newCount;
+            }
+
+            if (!pages[page])
+            {
+                Index* entries = Memory::Allocate<Index>(PageSize);
+                if (!entries) { return false; }
+
+                for (size_t i = 0; i < PageSize; ++i)
+                {
+                    entries[i] = InvalidIndex;
+                }
+                pages[page] = entries;
+            }
+
+            return (count < capacity || Find(record) != InvalidIndex) ? true : Grow();
+        }
+
+        /**
+         * @brief Insert an entity with a value initialized component, keeping the value of one already present.
+         * @param record The entity record index, Reserve() must have succeeded for it.
+         * @return The dense index of the entity.
+         */
+        Index Insert(Index record)
+        {
+            Index* entry = Entry(record);
+            if (*entry != InvalidIndex) { return *entry; }
+
+            if (ops->size)
+            {
+                ops->construct(values + ops->size * count);
+            }
+            entities[count] = record;
+            *entry = static_cast<Index>(count);
+            return static_cast<Index>(count++);
+        }
+
+        /**
+         * @brief Remove an entity, moving the last value into its slot.
+         * @param record The entity record index.
+         * @return True if the entity was in the set.
+         */
+        bool Erase(Index record)
+        {
+            Index* entry = Entry(record);
+            if (!entry || *entry == InvalidIndex) { return false; }
+
+            const size_t dense = *entry;
+            const size_t last = --count;
+
+            if (ops->size)
+            {
+                ops->destroy(values + ops->size * dense);
+                if (dense != last)
+                {
+                    ops->relocate(values + ops->size * dense, values + ops->size * last, 1);
+                }
+            }
+
+            if (dense != last)
+            {
+                entities[dense] = entities[last];
+                *Entry(entities[dense]) = static_cast<Index>(dense);
+            }
+            *entry = InvalidIndex;
+            return true;
+        }
+
+        /**
+         * @brief Remove every entity, keeping the storage.
+         */
+        void Clear()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (ops->size)
+                {
+                    ops->destroy(values + ops->size * i);
+                }
+                *Entry(entities[i]) = InvalidIndex;
+            }
+            count = 0;
+        }
+
+        /**
+         * @brief Remove every entity and free the storage.
+         */
+        void Release()
+        {
+            if (!ops) { return; }
+
+            Clear();
+
+            for (size_t i = 0; i < pageCount; ++i)
+            {
+                Memory::Deallocate(pages[i], PageSize);
+            }
+            Memory::Deallocate(pages, pageCount);
+            Memory::Deallocate(entities, capacity);
+            if (values)
+            {
+                Allocator::Deallocate(values, ops->size * capacity);
+            }
+
+            pages = nullptr;
+            pageCount = 0;
+            entities = nullptr;
+            values = nullptr;
+            capacity = 0;
+        }
+    };
+}
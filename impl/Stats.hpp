@@ -0,0 +1,169 @@
+#pragma once
+
+/**
+ * @file Stats.hpp
+ * @brief Statistics counters for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the types recording where a world spends time and
+ * memory when SECS_ENABLE_STATS is non-zero:
+ *
+ * - **StorageStats**: Growths of archetype columns and of the entity record
+ *   table, the bytes moved by reallocations, entity moves between archetypes
+ *   and row removals
+ * - **QueryStats**: Iterations, visited rows, skipped empty archetypes and
+ *   iteration time of one query
+ * - **ArchetypeStats**: Size and capacity of one archetype, and the bytes its
+ *   unused rows take
+ * - **ScopedTimer**: Accumulates the time spent in a scope into a TimerStats
+ *
+ * The counters of the current world are read through World::GetStats(),
+ * World::GetQueryStats() and World::EachArchetypeStats(). With stats disabled
+ * none of these exist and SECS records nothing.
+ *
+ * @par Example:
+ * ```cpp
+ * #define SECS_ENABLE_STATS 1
+ * #include <secs.hpp>
+ *
+ * auto move = [](Position* pos, const Velocity* vel) { pos->x += vel->dx; };
+ * it.Iterate(move);
+ *
+ * const QueryStats& stats = World::GetQueryStats<decltype(move)>();
+ * printf("%zu rows, %llu ns\n", stats.rowsVisited, (unsigned long long)stats.time.total);
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see Config.hpp For SECS_ENABLE_STATS and SECS_STATS_CLOCK
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Config.hpp"
+#include "Component.hpp"
+
+#if SECS_ENABLE_STATS
+#include <chrono>
+
+namespace SECS
+{
+    /**
+     * @brief Clock used when SECS_STATS_CLOCK is not defined
+     *
+     * @details
+     * Counts nanoseconds of std::chrono::steady_clock.
+     */
+    struct SteadyClock
+    {
+        /**
+         * @brief Read the current time.
+         * @return The time in nanoseconds since an unspecified epoch.
+         */
+        static uint64_t Now()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    };
+
+    /**
+     * @brief The clock selected through SECS_STATS_CLOCK.
+     */
+    using StatsClock = SECS_STATS_CLOCK;
+
+    /**
+     * @brief Time accumulated over several runs of a measured scope, in StatsClock ticks.
+     */
+    struct TimerStats
+    {
+        size_t count = 0;       /**< Number of measured runs. */
+        uint64_t total = 0;     /**< Ticks of all runs. */
+        uint64_t max = 0;       /**< Ticks of the longest run, spots frame spikes. */
+    };
+
+    /**
+     * @brief Measures the time until the end of its scope
+     *
+     * @details
+     * The elapsed ticks are added to a TimerStats when the timer is destroyed.
+     *
+     * @par Example:
+     * ```cpp
+     * static TimerStats physics;
+     * {
+     *     ScopedTimer timer(physics);
+     *     UpdatePhysics();
+     * }
+     * ```
+     */
+    class ScopedTimer
+    {
+        TimerStats& stats;
+        uint64_t start;
+
+    public:
+        /**
+         * @brief Start measuring.
+         * @param stats The statistics receiving the elapsed time.
+         */
+        explicit ScopedTimer(TimerStats& stats) : stats(stats), start(StatsClock::Now()) {}
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer()
+        {
+            const uint64_t elapsed = StatsClock::Now() - start;
+            stats.count++;
+            stats.total += elapsed;
+            stats.max = (elapsed > stats.max) ? elapsed : stats.max;
+        }
+    };
+
+    /**
+     * @brief Activity of the storage of a world.
+     */
+    struct StorageStats
+    {
+        size_t archetypeGrowths = 0;    /**< Capacity increases of archetype columns. */
+        size_t recordGrowths = 0;       /**< Capacity increases of the entity record table. */
+        size_t bytesMoved = 0;          /**< Bytes of rows and records moved into grown or shrunk storage. */
+        size_t entityMoves = 0;         /**< Entities moved into another archetype by adding or removing components. */
+        size_t rowRemovals = 0;         /**< Rows removed by destroying entities. */
+    };
+
+    /**
+     * @brief Activity of one query, a LookupCache instantiation.
+     * @details Counted by the iterations running the query, resolving its archetypes for
+     * other purposes such as World::SortHierarchy() counts nothing. Rows are counted when
+     * they are handed to the lambda, so rows skipped by Changed<> filters or after
+     * StopIteration() are not. Each lambda of EntityIterator::IterateFused() and each system
+     * of a Schedule counts as one iteration of its own query, as separate iterations would.
+     */
+    struct QueryStats
+    {
+        size_t iterations = 0;          /**< Number of iterations that ran the query. */
+        size_t rowsVisited = 0;         /**< Rows handed to the lambda, summed over the iterations. */
+        size_t archetypesSkipped = 0;   /**< Matched archetypes without entities, summed over the iterations. */
+        TimerStats time;                /**< Time of the iterations run through EntityIterator and IterateParallel(). */
+    };
+
+    /**
+     * @brief Occupancy of one archetype.
+     */
+    struct ArchetypeStats
+    {
+        Component::BinaryId id;         /**< Components of the archetype. */
+        size_t size;                    /**< Rows holding entities. */
+        size_t capacity;                /**< Rows storage is allocated for. */
+        size_t rowBytes;                /**< Bytes of one row, component columns and record index. */
+        size_t slackBytes;              /**< Bytes of the unused rows. */
+    };
+}
+#endif
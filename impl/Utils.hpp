@@ -276,4 +276,25 @@ namespace SECS
             return lambda.template operator() < Types... > ();
         }
     };
+
+    /**
+     * @brief Specialization of LambdaUtil for lambdas taking a leading element count
+     * 
+     * @tparam ReturnType The return type of the lambda
+     * @tparam ClassType The class type (lambda closure type)
+     * @tparam Types... The pointed-to types of the parameters following the count
+     * 
+     * @details
+     * Matches span lambdas of the form `(size_t count, Position* pos, ...)`,
+     * the count is not part of the extracted types.
+     */
+    template <class ReturnType, class ClassType, typename... Types>
+    struct LambdaUtil<ReturnType(ClassType::*)(size_t, Types* ...) const>
+    {
+        template <typename Lambda>
+        static auto CallWithTypes(Lambda lambda)
+        {
+            return lambda.template operator() < Types... > ();
+        }
+    };
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+
+/**
+ * @file View.hpp
+ * @brief Cached component access to one entity for the SECS library
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * This file contains the View class, an entity reference that remembers
+ * where the components it accesses are stored. EntityReference::Access()
+ * resolves the entity record, its archetype and every component column on
+ * each call; a view does that once and afterwards only compares one counter
+ * of the archetype before handing out the cached pointers. Systems touching
+ * the same few entities every frame, such as missiles homing on the player,
+ * skip the chain of dependent loads.
+ *
+ * @par Example:
+ * ```cpp
+ * View<Position> target(player);
+ *
+ * World::EntityIterator it;
+ * it.Iterate([&target](Position* pos, const Homing* homing) {
+ *     target.Access([pos, homing](const Position* goal) {
+ *         pos->x += (goal->x - pos->x) * homing->rate;
+ *         pos->y += (goal->y - pos->y) * homing->rate;
+ *     });
+ * });
+ * ```
+ *
+ * @warning This is an internal header and should not be included directly
+ *          in user code. Use the main SECS headers instead.
+ *
+ * @see EntityReference For uncached entity access
+ */
+
+#include <tuple>
+#include <type_traits>
+
+#include "Archetype.hpp"
+#include "EntityReference.hpp"
+
+namespace SECS
+{
+    /**
+     * @brief Entity reference caching the location of some of its components
+     *
+     * @details
+     * The cached pointers stay valid as long as no row leaves the archetype
+     * of the entity and its storage does not move, which every archetype
+     * counts in its row epoch. Access() compares the epoch and falls back to
+     * a full resolution when it changed, for instance because the entity or
+     * one of its archetype neighbours was destroyed or moved, or because the
+     * archetype grew. Adding entities to the archetype without growing it
+     * keeps the cache.
+     *
+     * Order and cv qualifiers of Ts do not matter. Like EntityReference, a
+     * view is only meaningful in the world its entity was created in.
+     *
+     * @tparam Ts The component types the view accesses, none of them sparse.
+     */
+    template <typename... Ts>
+    class View
+    {
+        static_assert(sizeof...(Ts) > 0, "A View accesses at least one component type");
+        static_assert((ComponentType<std::remove_cv_t<Ts>> && ...), "View components must be object types");
+
+        EntityReference entity;
+        Index archetype = InvalidIndex;     /**< Archetype the pointers were resolved in, InvalidIndex if unresolved. */
+        Index row = InvalidIndex;
+        size_t epoch = 0;                   /**< Row epoch of the archetype when the pointers were resolved. */
+        std::tuple<std::remove_cv_t<Ts>*...> components;
+
+        /**
+         * @brief Resolve the entity and cache the location of its components.
+         * @return true if the entity is valid and has all the component types.
+         */
+        bool Resolve()
+        {
+            archetype = InvalidIndex;
+            if (entity.recordIndex == InvalidIndex) { return false; }
+
+            const EntityRecord& record = EntityRecord::Get(entity.recordIndex);
+            if (!entity.Holds(record)) { return false; }
+
+            const ArchetypeManager& manager = ArchetypeManager::Get(record.archetype);
+            if (!manager.id.Contains(ArchetypeManager::Helper<Ts...>::id)) { return false; }
+
+            components = std::tuple<std::remove_cv_t<Ts>*...>(manager.GetComponent<std::remove_cv_t<Ts>>(record.row)...);
+            archetype = record.archetype;
+            row = record.row;
+            epoch = manager.rowEpoch;
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Default constructor for creating a view of no entity.
+         */
+        View() = default;
+
+        /**
+         * @brief Create a view of an entity.
+         * @details The entity is resolved on the first Access().
+         * @param entity The entity to access.
+         */
+        explicit View(const EntityReference& entity) : entity(entity) {}
+
+        /**
+         * @brief Get the entity the view accesses.
+         * @return The reference the view was created from.
+         */
+        const EntityReference& GetEntity() const { return entity; }
+
+        /**
+         * @brief Access the components of the entity through a lambda function.
+         * @details Same as EntityReference::Access(), restricted to the component types of the
+         * view. Non-const parameters of components opted into change detection mark them as written.
+         * @param lambda A callable object taking pointers to some of the component types of the view.
+         * @return true if the entity is valid, has every component type of the view and the lambda was executed.
+         */
+        template <typename Lambda>
+        bool Access(Lambda lambda)
+        {
+            if (archetype == InvalidIndex || ArchetypeManager::Get(archetype).rowEpoch != epoch)
+            {
+                if (!Resolve()) { return false; }
+            }
+
+            using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+            LambdaTraits::CallWithTypes([this, &lambda]<typename ...Components>()
+            {
+                lambda(std::get<std::remove_cv_t<Components>*>(components)...);
+                if constexpr (ArchetypeManager::WritesTracked<Components...>)
+                {
+                    ArchetypeManager::Get(archetype).MarkChanged(row, 1, ArchetypeManager::WrittenId<Components...>());
+                }
+            });
+            return true;
+        }
+    };
+}
@@ -14,7 +14,7 @@
  * for optimal cache performance and efficient entity management.
  * 
  * Key features:
- * - **Static interface**: No instantiation required, global entity management
+ * - **Static interface**: No instantiation required, operations target the current world
  * - **Type-safe operations**: Compile-time component type validation
  * - **Archetype-based storage**: Entities grouped by component combinations
  * - **Lambda-based initialization**: Efficient component setup patterns
@@ -26,6 +26,14 @@
  * World instance management and provides a clean, global interface for
  * entity operations throughout the application.
  * 
+ * @par Multiple Worlds:
+ * The static methods operate on the world current on the calling thread,
+ * which is a built-in default world unless a World instance was made
+ * current. Each instance owns its own entity records, archetypes, query
+ * caches and resources, so a staging world or per-thread simulations can
+ * live alongside the default one. Component types and hooks are shared by
+ * every world.
+ * 
  * @par Archetype Management:
  * Entities are automatically organized into archetypes based on their
  * component combinations. This provides excellent cache locality during
@@ -45,7 +53,16 @@
  * @see Component For component type management
  */
 
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 #include "EntityReference.hpp"
+#include "Executor.hpp"
+#include "Hierarchy.hpp"
+#include "Prefab.hpp"
+#include "Query.hpp"
 
 namespace SECS
 {
@@ -59,7 +76,7 @@ namespace SECS
      * combination are stored together for optimal cache performance.
      * 
      * @par Key Features:
-     * - Static interface (no instantiation required)
+     * - Static interface (no instantiation required), instances add independent worlds
      * - Type-safe entity creation with compile-time validation
      * - Efficient archetype-based storage
      * - Lambda-based component initialization
@@ -75,7 +92,8 @@ namespace SECS
      * 
      * @par Thread Safety:
      * This class is NOT thread-safe. External synchronization is required
-     * for concurrent access from multiple threads.
+     * for concurrent access to one world from multiple threads. Distinct
+     * worlds made current on distinct threads need no synchronization.
      * 
      * @par Usage Examples:
      * @code{.cpp}
@@ -106,6 +124,175 @@ namespace SECS
      */
     struct World
     {
+        template <typename...> friend class Schedule;
+
+    private:
+        /**
+         * @brief The instance of one resource type in one world.
+         */
+        struct ResourceEntry
+        {
+            void* instance = nullptr;
+            void (*release)(void* instance) = nullptr;  /**< Destroys the instance and releases its storage. */
+        };
+
+        /**
+         * @brief The storages selected as the current world of a thread.
+         */
+        struct CurrentWorld
+        {
+            EntityRecord::Storage* records;
+            ArchetypeManager::Storage* archetypes;
+            Vector<ResourceEntry>* resources;
+
+            /**
+             * @brief Get the current world of the calling thread.
+             * @return The storages of the current world.
+             */
+            static CurrentWorld Get()
+            {
+                return CurrentWorld{ EntityRecord::storage, ArchetypeManager::storage, World::resources };
+            }
+
+            /**
+             * @brief Make the storages the current world of the calling thread.
+             */
+            void Set() const
+            {
+                EntityRecord::storage = records;
+                ArchetypeManager::storage = archetypes;
+                World::resources = resources;
+            }
+        };
+
+        static inline size_t resourceSlots = 0;
+        static inline Vector<ResourceEntry> defaultResources;                                /**< Resources of the default world. */
+        static inline SECS_THREAD_LOCAL Vector<ResourceEntry>* resources = &defaultResources; /**< Resources of the world current on this thread. */
+
+        EntityRecord::Storage records;
+        ArchetypeManager::Storage archetypes;
+        Vector<ResourceEntry> resourceEntries;
+
+    public:
+        /**
+         * @brief Create an empty world
+         * 
+         * @details
+         * A world owns its entity records, archetypes, query caches and
+         * resources. Nothing is allocated until entities are created in it.
+         * The world becomes the target of the static functions once made
+         * current with MakeCurrent() or a World::Scope.
+         */
+        World() = default;
+
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        /**
+         * @brief Destroy every entity and resource of the world and release its storage
+         * 
+         * @details
+         * OnRemove hooks are not run. If the world is current on the calling
+         * thread, the default world becomes current again.
+         * 
+         * @warning The world must not be current on any other thread.
+         */
+        ~World()
+        {
+            if (EntityRecord::storage == &records) { MakeDefaultCurrent(); }
+
+            for (ResourceEntry& entry : resourceEntries)
+            {
+                if (entry.instance) { entry.release(entry.instance); }
+            }
+
+            for (ArchetypeManager& manager : archetypes.managers)
+            {
+                manager.Release();
+            }
+
+            for (SparseSet& set : archetypes.sparseSets)
+            {
+                set.Release();
+            }
+
+            Memory::Deallocate(records.records, records.capacity);
+        }
+
+        /**
+         * @brief Make this world the target of the static functions on the calling thread
+         * 
+         * @details
+         * Every static World function, EntityReference and CommandBuffer
+         * operates on the world current on the calling thread. Worlds made
+         * current on different threads are fully independent and can run
+         * simultaneously. Threads start with the default world current.
+         * 
+         * @warning EntityReference and EntityHandle values are only meaningful
+         *          in the world they were created in.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * World level;
+         * level.MakeCurrent();
+         * World::CreateEntity<Position, Sprite>();
+         * World::MakeDefaultCurrent();
+         * @endcode
+         * 
+         * @see Scope For switching worlds for the duration of a block
+         */
+        void MakeCurrent()
+        {
+            CurrentWorld{ &records, &archetypes, &resourceEntries }.Set();
+        }
+
+        /**
+         * @brief Make the default world the target of the static functions on the calling thread
+         */
+        static void MakeDefaultCurrent()
+        {
+            CurrentWorld{ &EntityRecord::defaultStorage, &ArchetypeManager::defaultStorage, &defaultResources }.Set();
+        }
+
+        /**
+         * @brief Makes a world current for the lifetime of the scope
+         * 
+         * @details
+         * The previously current world of the calling thread is restored when the
+         * scope ends.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * World staging;
+         * {
+         *     World::Scope scope(staging);
+         *     LoadLevel();
+         * }
+         * @endcode
+         */
+        class Scope
+        {
+            CurrentWorld previous;
+
+        public:
+            /**
+             * @brief Make a world current on the calling thread.
+             * @param world The world to make current.
+             */
+            explicit Scope(World& world) : previous(CurrentWorld::Get())
+            {
+                world.MakeCurrent();
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            /**
+             * @brief Restore the previously current world.
+             */
+            ~Scope() { previous.Set(); }
+        };
+
         /**
          * @brief Create a new entity with components using a lambda function for initialization
          * 
@@ -163,9 +350,15 @@ namespace SECS
             using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
             return LambdaTraits::CallWithTypes([&lambda]<typename ...Ts>()
             {
+                if (ArchetypeManager::IsLocked()) { return EntityReference(); }
+
                 auto& manager = ArchetypeManager::Helper<Ts...>::GetInstance();
                 const EntityRecord& record = manager.ReserveRecord();
-                lambda(&manager.template GetComponentArray<Ts>()[record.row] ...);
+                if (record.IsValid())
+                {
+                    lambda(manager.template GetComponent<Ts>(record.row) ...);
+                    EntityReference::RunHooks(record, manager.id, false);
+                }
                 return EntityReference(record);
             });
         }
@@ -181,7 +374,7 @@ namespace SECS
          * 
          * @tparam Ts Variadic template parameter pack specifying the component
          *            types to include in the entity. Each type must satisfy
-         *            the ComponentType concept (non-empty types).
+         *            the ComponentType concept, empty types are stored as tags.
          * 
          * @return EntityReference A handle to the newly created entity with
          *                        uninitialized components. The reference will
@@ -240,67 +433,1738 @@ namespace SECS
         template <typename... Ts>
         static EntityReference CreateEntity()
         {
+            if (ArchetypeManager::IsLocked()) { return EntityReference(); }
+
             ArchetypeManager& manager = ArchetypeManager::Helper<Ts...>::GetInstance();
-            return EntityReference(manager.ReserveRecord());
+            const EntityRecord& record = manager.ReserveRecord();
+            if (record.IsValid())
+            {
+                EntityReference::RunHooks(record, manager.id, false);
+            }
+            return EntityReference(record);
         }
 
         /**
-         * @brief Represents an iterator for entities in the ECS world.
+         * @brief Pre-allocate storage for entities with the specified component types
+         * 
+         * @details
+         * Grows the archetype for the given component combination and the entity
+         * record table in one step, so that the next `count` entities created with
+         * these components trigger no reallocation. Call it at load time or before
+         * a spawn wave to move allocation cost out of the frame.
+         * 
+         * @tparam Ts The component types of the archetype to pre-size.
+         * 
+         * @param count The number of entities to make room for, on top of the existing ones.
+         * 
+         * @return bool Returns true if the storage is available, false if allocation failed.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * // At level load, make room for the largest bullet wave
+         * World::Reserve<Position, Velocity, Bullet>(500);
+         * @endcode
+         * 
+         * @see CreateEntities() For creating many entities at once
          */
-        class EntityIterator
+        template <typename... Ts>
+        static bool Reserve(Index count)
         {
-            ArchetypeManager* currentManager = nullptr;
-            Index currentRow = InvalidIndex;
-            bool stop = false;
-        public:
-            /**
-             * @brief Stops the current iteration.
-             */
-            void StopIteration() { stop = true; };
+            if (ArchetypeManager::IsLocked()) { return false; }
 
-            /**
-             * @brief Get a reference to the current entity in the iteration.
-             * @return An EntityReference to the current entity, if available, or an empty one.
-             */
-            EntityReference GetCurrentEntity()
+            ArchetypeManager& manager = ArchetypeManager::Helper<Ts...>::GetInstance();
+            return manager.Grow(size_t(manager.size) + count) && EntityRecord::ReserveCapacity(count);
+        }
+
+        /**
+         * @brief Return the unused storage of the current world to the allocator
+         * 
+         * @details
+         * Shrinks the columns of every archetype to the entities it holds, releases
+         * the whole storage of empty archetypes and trims the entity record table
+         * to the records ever handed out. Archetypes themselves stay registered,
+         * so they grow again like new ones when entities are added to them. Call it
+         * after unloading a level, so that the next one can use the memory.
+         * 
+         * With SECS_CHUNK_SIZE storage is released in whole chunks. The record table
+         * never shrinks below the largest number of entities the world held at once:
+         * records of destroyed entities keep the versions that make references to
+         * them fail, so only the part reserved beyond that peak is reclaimed.
+         * 
+         * @return bool Returns true if everything was shrunk, false if the world is locked
+         *         by a dispatch or some storage could not be reallocated, which is then
+         *         left as it was.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * UnloadLevel();      // destroys the entities of the level
+         * World::Compact();
+         * LoadLevel(next);
+         * @endcode
+         * 
+         * @see AutoCompact() For compacting gradually during play
+         */
+        static bool Compact()
+        {
+            if (ArchetypeManager::IsLocked()) { return false; }
+
+            bool status = true;
+            for (ArchetypeManager& manager : ArchetypeManager::storage->managers)
             {
-                return (currentRow != InvalidIndex) ?
-                    EntityReference(EntityRecord::records[currentManager->recordIndices[currentRow]]) :
-                    EntityReference();
+                status = manager.Shrink(manager.size) && status;
+                manager.idleFrames = 0;
             }
+            return EntityRecord::Shrink(0) && status;
+        }
 
-            /**
-             * @brief Iterate over entities with specified component types and execute a lambda function.
-             * @tparam Lambda The lambda function to execute for each entity.
-             * @param lambda The lambda function to execute for each entity, providing access to entity components.
-             */
-            template <typename Lambda>
-            void Iterate(Lambda lambda)
+        /**
+         * @brief Apply the automatic compaction policy to the current world
+         * 
+         * @details
+         * Meant to be called once per frame. Each call is one frame for the policy:
+         * - The storage of archetypes that were empty for SECS_COMPACT_IDLE_FRAMES
+         *   consecutive calls is released.
+         * - Archetypes holding entities in less than 1 / SECS_COMPACT_LOW_WATER of
+         *   their rows are shrunk to twice their size, and so is the record table
+         *   compared to the records ever handed out, see Compact().
+         * 
+         * Storage pre-allocated with Reserve() is subject to the policy as well. The
+         * call does nothing while the world is locked by a dispatch.
+         * 
+         * @see Compact() For releasing everything at once
+         */
+        static void AutoCompact()
+        {
+            if (ArchetypeManager::IsLocked()) { return; }
+
+            for (ArchetypeManager& manager : ArchetypeManager::storage->managers)
             {
-                stop = false;
-                using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
-                LambdaTraits::CallWithTypes([this, lambda]<typename ...Components>()
+                if (manager.size == 0)
                 {
-                    using LookupCache = ArchetypeManager::LookupCache<Components...>;
-                    LookupCache::Update();
-
-                    for (size_t managerIndex : LookupCache::matchedIndices)
+                    if (SECS_COMPACT_IDLE_FRAMES && manager.capacity && ++manager.idleFrames >= SECS_COMPACT_IDLE_FRAMES)
                     {
-                        if (stop) break;
+                        manager.Shrink(0);
+                        manager.idleFrames = 0;
+                    }
+                    continue;
+                }
+
+                manager.idleFrames = 0;
+                if (SECS_COMPACT_LOW_WATER && size_t(manager.size) * SECS_COMPACT_LOW_WATER < manager.capacity)
+                {
+                    manager.Shrink(size_t(manager.size) * 2);
+                }
+            }
+
+            const EntityRecord::Storage& records = *EntityRecord::storage;
+            if (SECS_COMPACT_LOW_WATER && records.issued * SECS_COMPACT_LOW_WATER < records.capacity)
+            {
+                EntityRecord::Shrink(records.issued * 2);
+            }
+        }
+
+        /**
+         * @brief Create many entities with components initialized through a lambda function
+         * 
+         * @details
+         * Batch version of CreateEntity(Lambda). Storage for the whole batch is
+         * reserved up front with a single capacity check, the entities occupy a
+         * contiguous range of rows in their archetype, and the lambda is called once
+         * per entity with pointers to its components.
+         * 
+         * @param count The number of entities to create.
+         * @param lambda A callable object taking pointers to the component types, called once per entity.
+         * @param references Optional array receiving a reference to each created entity,
+         *                   must hold at least `count` elements.
+         * 
+         * @return Index The number of entities created: either `count`, or 0 if
+         *               storage for the batch could not be allocated.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * size_t index = 0;
+         * World::CreateEntities(500, [&index](Position* pos, Velocity* vel) {
+         *     pos->x = 160.0f;
+         *     pos->y = 112.0f;
+         *     vel->dx = waveDirections[index].dx;
+         *     vel->dy = waveDirections[index++].dy;
+         * });
+         * @endcode
+         * 
+         * @see CreateEntity(Lambda) For creating a single entity
+         * @see Reserve() For pre-allocating without creating entities
+         */
+        template <typename Lambda>
+        static Index CreateEntities(Index count, Lambda lambda, EntityReference* references = nullptr)
+        {
+            using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+            return LambdaTraits::CallWithTypes([count, &lambda, references]<typename ...Ts>()
+            {
+                if (ArchetypeManager::IsLocked()) { return Index(0); }
 
-                        currentManager = &ArchetypeManager::managers[managerIndex];
+                ArchetypeManager& manager = ArchetypeManager::Helper<Ts...>::GetInstance();
+                Index first = manager.ReserveRecords(count);
+                if (first == InvalidIndex) { return Index(0); }
 
-                        [this, lambda](Components* ...componentArray)
+                manager.EachSpan(first, first + count, [&manager, &lambda](Index spanFirst, Index spanCount)
+                {
+                    [&lambda, spanCount](Ts* ...componentArray)
+                    {
+                        for (Index i = 0; i < spanCount; ++i)
                         {
-                            for (currentRow = 0; !stop && currentRow < currentManager->size; currentRow++)
-                            {
-                                lambda(componentArray++...);
-                            }
-                        }(currentManager->template GetComponentArray<Components>() ...);
-                    }
+                            lambda(componentArray...);
+                            ((componentArray = QueryFilter<>::Next(componentArray)), ...);
+                        }
+                    }(manager.template GetComponent<Ts>(spanFirst) ...);
                 });
-                currentRow = InvalidIndex;
-            }
-        };
+
+                RunCreationHooks(manager, first, count);
+                GetReferences(manager, first, count, references);
+                return count;
+            });
+        }
+
+        /**
+         * @brief Create many entities with explicitly specified component types
+         * 
+         * @details
+         * Batch version of CreateEntity<Ts...>(), with the same single up-front
+         * reservation as CreateEntities(Lambda). The components are left default
+         * constructed.
+         * 
+         * @tparam Ts The component types of the entities.
+         * 
+         * @param count The number of entities to create.
+         * @param references Optional array receiving a reference to each created entity,
+         *                   must hold at least `count` elements.
+         * 
+         * @return Index The number of entities created: either `count`, or 0 if
+         *               storage for the batch could not be allocated.
+         * 
+         * @see CreateEntities(Lambda) For creating and initializing many entities
+         */
+        template <typename... Ts>
+        static Index CreateEntities(Index count, EntityReference* references = nullptr)
+        {
+            if (ArchetypeManager::IsLocked()) { return 0; }
+
+            ArchetypeManager& manager = ArchetypeManager::Helper<Ts...>::GetInstance();
+            Index first = manager.ReserveRecords(count);
+            if (first == InvalidIndex) { return 0; }
+
+            RunCreationHooks(manager, first, count);
+            GetReferences(manager, first, count, references);
+            return count;
+        }
+
+        /**
+         * @brief Create many entities as copies of a prefab
+         * 
+         * @details
+         * Reserves storage for the whole batch like CreateEntities(), then copies
+         * the components of the prefab into the new rows span by span, without
+         * calling an initialization lambda per entity. OnAdd hooks run once the
+         * components are copied.
+         * 
+         * @tparam Ts The component types of the prefab.
+         * 
+         * @param prefab The prefab to copy.
+         * @param count The number of entities to create.
+         * @param references Optional array receiving a reference to each created entity,
+         *                   must hold at least `count` elements.
+         * 
+         * @return Index The number of entities created: either `count`, or 0 if
+         *               storage for the batch could not be allocated.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * Prefab<Position, Velocity, Particle> spark([](Velocity* vel, Particle* particle) {
+         *     vel->dy = -1.0f;
+         *     particle->frames = 30;
+         * });
+         * 
+         * spark.Get<Position>()->x = emitterX;
+         * World::Instantiate(spark, 64);
+         * @endcode
+         * 
+         * @see Prefab For building the component values
+         */
+        template <typename... Ts>
+        static Index Instantiate(const Prefab<Ts...>& prefab, Index count, EntityReference* references = nullptr)
+        {
+            if (ArchetypeManager::IsLocked()) { return 0; }
+
+            ArchetypeManager& manager = ArchetypeManager::Helper<Ts...>::GetInstance();
+            Index first = manager.ReserveRecords(count, manager.columnsId);
+            if (first == InvalidIndex) { return 0; }
+
+            manager.EachSpan(first, first + count, [&manager, &prefab](Index spanFirst, Index spanCount)
+            {
+                (prefab.Fill(manager.template GetComponent<std::remove_cv_t<Ts>>(spanFirst), spanCount), ...);
+            });
+
+            RunCreationHooks(manager, first, count);
+            GetReferences(manager, first, count, references);
+            return count;
+        }
+
+        /**
+         * @brief Create an entity as a copy of a prefab
+         * 
+         * @tparam Ts The component types of the prefab.
+         * @param prefab The prefab to copy.
+         * @return EntityReference A reference to the new entity, or an invalid
+         *                        EntityReference if storage could not be allocated.
+         * 
+         * @see Instantiate(const Prefab<Ts...>&, Index, EntityReference*) For creating many copies
+         */
+        template <typename... Ts>
+        static EntityReference Instantiate(const Prefab<Ts...>& prefab)
+        {
+            EntityReference entity;
+            Instantiate(prefab, 1, &entity);
+            return entity;
+        }
+
+        /**
+         * @brief Register a callback run whenever an entity gains a component type
+         * 
+         * @details
+         * The hook runs when an entity is created with the component, including
+         * through CreateEntities() and CommandBuffer::Flush(), and when the
+         * component is added with EntityReference::Add(). It runs after the
+         * component was initialized by the creation or addition lambda, so external
+         * structures such as spatial grids can index the entity incrementally.
+         * 
+         * Hooks run with the world locked against structural changes: creating or
+         * destroying entities and adding or removing components from a hook fails,
+         * record such changes in a CommandBuffer instead. Tags have no storage, their
+         * hooks receive nullptr as the component.
+         * 
+         * @tparam T The component type.
+         * @param hook A function taking the entity and a pointer to its component, nullptr unregisters the hook.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * World::OnAdd<Position>([](EntityReference entity, Position* pos) {
+         *     grid.Insert(entity, pos->x, pos->y);
+         * });
+         * @endcode
+         * 
+         * @see OnRemove() For the opposite transition
+         */
+        template <typename T>
+        static void OnAdd(void (*hook)(EntityReference entity, T* component))
+        {
+            SetHook<T>(hook, false);
+        }
+
+        /**
+         * @brief Register a callback run whenever an entity loses a component type
+         * 
+         * @details
+         * The hook runs when the component is removed with EntityReference::Remove()
+         * and when an entity having it is destroyed, including batched destruction
+         * in CommandBuffer::Flush(). It runs before the component goes away, so it
+         * can still be read. The same restrictions as for OnAdd() apply.
+         * 
+         * @tparam T The component type.
+         * @param hook A function taking the entity and a pointer to its component, nullptr unregisters the hook.
+         * 
+         * @see OnAdd() For the opposite transition
+         */
+        template <typename T>
+        static void OnRemove(void (*hook)(EntityReference entity, T* component))
+        {
+            SetHook<T>(hook, true);
+        }
+
+        /**
+         * @brief Make an entity the child of another one
+         * 
+         * @details
+         * Adds a ChildOf component to the child, or updates the one it has. Depths
+         * are recomputed and rows sorted by the next SortHierarchy() call, which
+         * EntityIterator::IterateHierarchy() makes itself.
+         * 
+         * @param child The entity to link.
+         * @param parent The new parent.
+         * @return bool Returns true if the child is now linked to the parent, false if
+         *              either entity is invalid, the parent is the child or one of its
+         *              descendants, storage could not be allocated or a
+         *              World::IterateParallel dispatch is in progress.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * EntityReference wheel = World::CreateEntity<Transform, LocalTransform>();
+         * World::SetParent(wheel, car);
+         * @endcode
+         * 
+         * @see ClearParent() For unlinking an entity
+         */
+        static bool SetParent(EntityReference child, EntityReference parent)
+        {
+            if (!RecordOf(child) || !RecordOf(parent)) { return false; }
+
+            // The parent must not descend from the child
+            const ChildOf* link = nullptr;
+            size_t steps = 0;
+            for (EntityReference ancestor = parent; RecordOf(ancestor) && steps <= EntityRecord::storage->last;
+                ancestor = link->parent, ++steps)
+            {
+                if (ancestor.recordIndex == child.recordIndex) { return false; }
+                link = LinkOf(ancestor);
+                if (!link) { break; }
+            }
+
+            if (!child.Add([parent](ChildOf* childLink) { childLink->parent = parent; })) { return false; }
+            ArchetypeManager::storage->hierarchyDirty = true;
+            return true;
+        }
+
+        /**
+         * @brief Turn an entity into a root of the hierarchy
+         * 
+         * @details Removes the ChildOf component of the entity, its own children stay linked to it.
+         * @param child The entity to unlink.
+         * @return bool Returns true if the entity is valid and has no parent anymore, false otherwise.
+         */
+        static bool ClearParent(EntityReference child)
+        {
+            if (!RecordOf(child) || !child.Remove<ChildOf>()) { return false; }
+            ArchetypeManager::storage->hierarchyDirty = true;
+            return true;
+        }
+
+        /**
+         * @brief Get the parent of an entity
+         * @param child The entity.
+         * @return EntityReference The parent, or an empty reference for roots, invalid
+         *         entities and children of destroyed parents.
+         */
+        static EntityReference GetParent(EntityReference child)
+        {
+            const ChildOf* link = LinkOf(child);
+            return (link && RecordOf(link->parent)) ? link->parent : EntityReference();
+        }
+
+        /**
+         * @brief Bring the hierarchy up to date for IterateHierarchy()
+         * 
+         * @details
+         * Recomputes the depth of every linked entity if parent links changed, then
+         * sorts the rows of each archetype holding ChildOf by depth, grouping siblings,
+         * unless they already are. Entities moved into such archetypes since the
+         * previous call are appended out of order, so the order of an archetype is
+         * checked, in one pass over its links, whenever rows were added to it, left it
+         * or moved since the previous call, or depths were recomputed. Otherwise the
+         * call only sums the rows added to the linked archetypes.
+         * 
+         * Links made without SetParent(), by adding ChildOf, creating or instantiating
+         * entities holding it, or loading a snapshot, are found through the rows added
+         * to the archetypes holding ChildOf and also recompute every depth. Changing
+         * the parent of an existing link other than through SetParent() is not detected.
+         * 
+         * Sorting moves rows, like destroying an entity does: rows count as written
+         * for change detection and View caches are resolved again.
+         * 
+         * @return bool Returns true if the hierarchy is sorted, false if storage could
+         *              not be allocated or a World::IterateParallel dispatch is in progress.
+         */
+        static bool SortHierarchy()
+        {
+            if (ArchetypeManager::IsLocked()) { return false; }
+
+            const Vector<Index>& linked = ArchetypeManager::LookupCache<ChildOf>::Update();
+            ArchetypeManager::Storage& archetypes = *ArchetypeManager::storage;
+
+            // Rows only count up, the sum changes whenever one of the archetypes gained rows
+            size_t rows = 0;
+            for (Index managerIndex : linked)
+            {
+                rows += ArchetypeManager::Get(managerIndex).rowsAdded;
+            }
+
+            const bool relinked = archetypes.hierarchyDirty || rows != archetypes.hierarchyRows;
+            if (relinked)
+            {
+                for (Index managerIndex : linked)
+                {
+                    ArchetypeManager& manager = ArchetypeManager::Get(managerIndex);
+                    for (Index row = 0; row < manager.size; ++row)
+                    {
+                        ChildOf* link = manager.GetComponent<ChildOf>(row);
+                        link->depth = DepthOf(*link);
+                    }
+                }
+                archetypes.hierarchyDirty = false;
+                archetypes.hierarchyRows = rows;
+            }
+
+            for (Index managerIndex : linked)
+            {
+                ArchetypeManager& manager = ArchetypeManager::Get(managerIndex);
+                auto less = [&manager](Index a, Index b)
+                {
+                    const ChildOf* first = manager.GetComponent<ChildOf>(a);
+                    const ChildOf* second = manager.GetComponent<ChildOf>(b);
+                    return (first->depth != second->depth) ? first->depth < second->depth :
+                        first->parent.recordIndex < second->parent.recordIndex;
+                };
+
+                // Rows neither left, moved nor were added since the previous sort, and depths hold
+                if (!relinked && manager.sortedStamp == manager.rowEpoch + manager.rowsAdded) { continue; }
+
+                bool sorted = true;
+                for (Index row = 1; sorted && row < manager.size; ++row)
+                {
+                    sorted = !less(row, row - 1);
+                }
+
+                if (!sorted && !manager.SortRows(less)) { return false; }
+                manager.sortedStamp = manager.rowEpoch + manager.rowsAdded;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Get the world-wide instance of a resource type
+         * 
+         * @details
+         * Resources hold global data such as input state, the camera or frame
+         * timers. They are not entities: each type has one instance reached
+         * through a per-type static pointer, without entity record, archetype
+         * or version check. The instance is default constructed on first use,
+         * in storage obtained from SECS_ALLOCATOR.
+         * 
+         * @tparam T The resource type.
+         * @return T* The instance, or nullptr if its storage could not be allocated.
+         *            The pointer stays valid until RemoveResource<T>() is called.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * World::EmplaceResource<Camera>(160.0f, 112.0f);
+         * 
+         * const Camera* camera = World::Resource<Camera>();
+         * World::EntityIterator it;
+         * it.Iterate([camera](const Position* pos, Sprite* sprite) {
+         *     DrawSprite(sprite->id, pos->x - camera->x, pos->y - camera->y);
+         * });
+         * @endcode
+         * 
+         * @see EmplaceResource() For constructing a resource with arguments
+         */
+        template <typename T>
+        static T* Resource()
+        {
+            const size_t slot = ResourceSlot<T>::slot;
+            const Vector<ResourceEntry>& entries = *resources;
+            T* instance = (slot < entries.size()) ? static_cast<T*>(entries[slot].instance) : nullptr;
+            return instance ? instance : EmplaceResource<T>();
+        }
+
+        /**
+         * @brief Construct the world-wide instance of a resource type
+         * 
+         * @details
+         * Replaces the current instance, if any, with one constructed from the
+         * given arguments. The storage of an existing instance is reused.
+         * 
+         * @tparam T The resource type.
+         * @tparam Args The types of the constructor arguments.
+         * @param args The constructor arguments.
+         * @return T* The new instance, or nullptr if its storage could not be allocated.
+         * 
+         * @see Resource() For accessing the instance
+         */
+        template <typename T, typename... Args>
+        static T* EmplaceResource(Args&&... args)
+        {
+            Vector<ResourceEntry>& entries = *resources;
+            if (entries.size() < resourceSlots) { entries.resize(resourceSlots); }
+
+            ResourceEntry& entry = entries[ResourceSlot<T>::slot];
+            if (entry.instance)
+            {
+                static_cast<T*>(entry.instance)->~T();
+            }
+            else
+            {
+                entry.instance = Memory::Allocate<T>(1);
+                if (!entry.instance) { return nullptr; }
+                entry.release = &ReleaseResource<T>;
+            }
+
+            return new (entry.instance) T(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Destroy the world-wide instance of a resource type and release its storage
+         * 
+         * @details
+         * Has no effect if the resource does not exist. A later call to
+         * Resource<T>() creates a new default constructed instance.
+         * 
+         * @tparam T The resource type.
+         */
+        template <typename T>
+        static void RemoveResource()
+        {
+            const size_t slot = ResourceSlot<T>::slot;
+            Vector<ResourceEntry>& entries = *resources;
+            if (slot < entries.size() && entries[slot].instance)
+            {
+                ReleaseResource<T>(entries[slot].instance);
+                entries[slot].instance = nullptr;
+            }
+        }
+
+#if SECS_ENABLE_STATS
+        /**
+         * @brief Get the storage activity of the current world
+         * 
+         * @details
+         * Counts growths of archetype columns and of the entity record table, the
+         * bytes moved into the grown storage, entity moves between archetypes and
+         * row removals since the world was created or since the last ResetStats().
+         * Only available when SECS_ENABLE_STATS is non-zero.
+         * 
+         * @return StorageStats The counters of the current world.
+         */
+        static StorageStats GetStats()
+        {
+            StorageStats stats = ArchetypeManager::storage->stats;
+            stats.recordGrowths += EntityRecord::storage->stats.recordGrowths;
+            stats.bytesMoved += EntityRecord::storage->stats.bytesMoved;
+            return stats;
+        }
+
+        /**
+         * @brief Get the activity of the query run by a system
+         * 
+         * @details
+         * Queries are shared by every system taking the same components with the
+         * same filters, regardless of order and const qualifiers. Only available
+         * when SECS_ENABLE_STATS is non-zero.
+         * 
+         * @tparam Lambda The lambda type of the system.
+         * @tparam Filters The filters the system iterates with.
+         * @return const QueryStats& The counters of the query in the current world.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * auto move = [](Position* pos, const Velocity* vel) { ... };
+         * it.Iterate<Without<Dead>>(move);
+         * 
+         * const QueryStats& stats = World::GetQueryStats<decltype(move), Without<Dead>>();
+         * @endcode
+         */
+        template <typename Lambda, typename... Filters>
+        static const QueryStats& GetQueryStats()
+        {
+            using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+            return *LambdaTraits::CallWithTypes([]<typename ...Components>()
+            {
+                using LookupCache = ArchetypeManager::FilteredLookupCache<QueryFilter<Filters...>, Components...>;
+                return &ArchetypeManager::Cache(LookupCache::slot).stats;
+            });
+        }
+
+        /**
+         * @brief Call a function with the occupancy of every archetype of the current world
+         * 
+         * @details
+         * Archetypes whose slack is large compared to their size hold on to storage
+         * sized for a past peak. Only available when SECS_ENABLE_STATS is non-zero.
+         * 
+         * @tparam Callback A callable type taking a `const ArchetypeStats&`.
+         * @param callback The function called once per archetype.
+         */
+        template <typename Callback>
+        static void EachArchetypeStats(Callback callback)
+        {
+            for (const ArchetypeManager& manager : ArchetypeManager::storage->managers)
+            {
+                const size_t rowBytes = manager.RowBytes();
+                callback(ArchetypeStats{ manager.id, manager.size, manager.capacity, rowBytes,
+                    rowBytes * (manager.capacity - manager.size) });
+            }
+        }
+
+        /**
+         * @brief Reset the storage and query counters of the current world.
+         * @details Only available when SECS_ENABLE_STATS is non-zero.
+         */
+        static void ResetStats()
+        {
+            ArchetypeManager::storage->stats = StorageStats();
+            EntityRecord::storage->stats = StorageStats();
+            for (ArchetypeManager::QueryCache& cache : ArchetypeManager::storage->queryCaches)
+            {
+                cache.stats = QueryStats();
+            }
+        }
+#endif
+
+        /**
+         * @brief Components read and written by a system
+         * 
+         * @details
+         * Describes which component columns a lambda touches. Two systems whose
+         * access does not conflict can safely run at the same time.
+         */
+        struct ComponentAccess
+        {
+            Component::BinaryId read;   /**< Components accessed through const pointers. */
+            Component::BinaryId write;  /**< Components accessed through non-const pointers. */
+
+            /**
+             * @brief Check whether two systems may not run concurrently.
+             * @param other The access of the other system.
+             * @return true if either system writes a component the other one reads or writes.
+             */
+            bool ConflictsWith(const ComponentAccess& other) const
+            {
+                return write.Intersects(other.read | other.write) || other.write.Intersects(read);
+            }
+        };
+
+        /**
+         * @brief Deduce the components read and written by a lambda from its signature
+         * 
+         * @details
+         * Parameters that are pointers to const components are reads, all other
+         * component parameters are writes.
+         * 
+         * @tparam Lambda A callable type taking pointers to component types, as passed to
+         *                EntityIterator::Iterate(), EntityIterator::IterateChunks() or IterateParallel().
+         * 
+         * @return ComponentAccess The read and write component sets of the lambda.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * auto move = [](Position* pos, const Velocity* vel) { ... };
+         * auto draw = [](const Position* pos, const Sprite* sprite) { ... };
+         * 
+         * // true: move writes Position, which draw reads
+         * bool conflict = World::AccessOf<decltype(move)>().ConflictsWith(World::AccessOf<decltype(draw)>());
+         * @endcode
+         */
+        template <typename Lambda>
+        static ComponentAccess AccessOf()
+        {
+            using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+            return LambdaTraits::CallWithTypes([]<typename ...Components>()
+            {
+                ComponentAccess access;
+                ((std::is_const_v<Components> ?
+                    access.read |= ArchetypeManager::Helper<Components>::id :
+                    access.write |= ArchetypeManager::Helper<Components>::id), ...);
+                return access;
+            });
+        }
+
+        /**
+         * @brief Iterate over entities with specified component types on several workers
+         * 
+         * @details
+         * The matched archetypes are split into jobs of at most SECS_JOB_ROWS rows,
+         * which are handed to the executor selected by SECS_EXECUTOR. Each job calls
+         * the lambda once per entity of its row range, the same way
+         * EntityIterator::Iterate() does. The call returns once every job has completed.
+         * 
+         * While the jobs run, the world is locked against structural changes:
+         * creating entities, destroying them and adding or removing components fail
+         * without effect, so archetype and entity record storage stays unchanged for
+         * the whole dispatch. Record such changes in a CommandBuffer per worker and
+         * flush them afterwards.
+         * 
+         * The jobs are kept in a list owned by the world, which only grows when a
+         * dispatch needs more jobs than any previous one, so dispatching every frame
+         * does not allocate. A dispatch started while the world is locked, from the
+         * jobs of another dispatch or from a hook, would reuse that list under the
+         * running jobs and fails without visiting anything.
+         * 
+         * Declaring read-only components as pointers to const documents the access
+         * of the system, see AccessOf(), and keeps components opted into change
+         * detection from being marked as written. Changed<> filters are not
+         * supported here.
+         * 
+         * @tparam Filters Optional With, Without and Optional filters refining the visited entities.
+         * @tparam Lambda The lambda function to execute for each entity.
+         * @param lambda The lambda function taking pointers to the component types. It is
+         *               called concurrently from several workers, captured state it modifies
+         *               must be synchronized by the caller.
+         * @return bool Returns false without visiting anything if the world is locked, true otherwise.
+         * 
+         * @par Example Usage:
+         * @code{.cpp}
+         * World::IterateParallel([](Position* pos, const Velocity* vel) {
+         *     pos->x += vel->dx;
+         *     pos->y += vel->dy;
+         * });
+         * @endcode
+         * 
+         * @see Executor.hpp For plugging in a job system
+         */
+        template <typename... Filters, typename Lambda>
+        static bool IterateParallel(Lambda lambda)
+        {
+            if (ArchetypeManager::IsLocked()) { return false; }
+
+            using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+            LambdaTraits::CallWithTypes([&lambda]<typename ...Components>()
+            {
+                static_assert(!QueryFilter<Filters...>::HasChanged,
+                    "Changed<> filters need the per-iterator tick of EntityIterator::Iterate()");
+                static_assert(!ArchetypeManager::HasSparse<Components...>,
+                    "IterateParallel() jobs take rows of columns, sparse components cannot be parameters, see SECS::SparseStorage");
+
+                using LookupCache = ArchetypeManager::FilteredLookupCache<QueryFilter<Filters...>, Components...>;
+#if SECS_ENABLE_STATS
+                const ScopedTimer timer(ArchetypeManager::Cache(LookupCache::slot).stats.time);
+#endif
+                const Vector<Index>& active = LookupCache::Update();
+
+                // Counted up front, workers never write to the query stats
+                LookupCache::CountIteration();
+                for (Index managerIndex : active)
+                {
+                    ArchetypeManager& manager = ArchetypeManager::Get(managerIndex);
+                    MarkDispatched<Components...>(manager);
+#if SECS_ENABLE_STATS
+                    Index rows = manager.size;
+                    if constexpr (QueryFilter<Filters...>::HasSparse)
+                    {
+                        rows = 0;
+                        for (Index row = 0; row < manager.size; ++row)
+                        {
+                            rows += RowMatches<QueryFilter<Filters...>>(manager, row);
+                        }
+                    }
+                    LookupCache::CountVisited(rows);
+#endif
+                }
+
+                // Workers check sparse filter terms, the sets they read must exist before the dispatch
+                QueryFilter<Filters...>::PrepareSparse();
+
+                const Vector<ArchetypeManager::Job>& jobs = SplitJobs([&active](auto&& split)
+                {
+                    for (Index managerIndex : active)
+                    {
+                        split(ArchetypeManager::Get(managerIndex), 0);
+                    }
+                });
+                Dispatch<Lambda, &RunRows<QueryFilter<Filters...>, Lambda, Components...>>(lambda, jobs);
+            });
+            return true;
+        }
+
+        /**
+         * @brief Represents an iterator for entities in the ECS world.
+         */
+        class EntityIterator
+        {
+            ArchetypeManager* currentManager = nullptr;
+            Index currentRow = InvalidIndex;
+            bool stop = false;
+            uint32_t lastChangeTick = 0;    /**< Change tick seen by the previous iteration with a Changed<> filter. */
+        public:
+            /**
+             * @brief Stops the current iteration.
+             */
+            void StopIteration() { stop = true; };
+
+            /**
+             * @brief Get a reference to the current entity in the iteration.
+             * @return An EntityReference to the current entity, if available, or an empty one.
+             */
+            EntityReference GetCurrentEntity()
+            {
+                return (currentRow != InvalidIndex) ?
+                    EntityReference(EntityRecord::Get(currentManager->RecordIndex(currentRow))) :
+                    EntityReference();
+            }
+
+            /**
+             * @brief Iterate over entities with specified component types and execute a lambda function.
+             * @details Filters are given as explicit template arguments, e.g.
+             * `Iterate<Without<Dead>, Optional<Sprite>>(lambda)`. Optional components missing from an
+             * entity are passed as nullptr.
+             *
+             * With a Changed<> filter only the blocks of rows written since this iterator's previous
+             * Changed<> iteration are visited, so each system should keep its own EntityIterator.
+             * Non-const parameters of components opted into change detection mark the visited rows
+             * as written.
+             *
+             * Queries taking components opted into SparseStorage visit the entities of the smallest of
+             * their required sparse sets instead of archetypes, in no particular order. The lambda may
+             * remove sparse components from any entity or destroy it, entities that no longer match
+             * when reached are skipped and no entity is visited twice; entities added to the set
+             * during the pass are not visited. Such queries do not support Changed<> filters.
+             *
+             * With and Without filters may name sparse components, which are then checked on each
+             * row of the matched archetypes.
+             * @tparam Filters Optional With, Without, Optional and Changed filters refining the visited entities.
+             * @tparam Lambda The lambda function to execute for each entity.
+             * @param lambda The lambda function to execute for each entity, providing access to entity components.
+             */
+            template <typename... Filters, typename Lambda>
+            void Iterate(Lambda lambda)
+            {
+                stop = false;
+                using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+                LambdaTraits::CallWithTypes([this, lambda]<typename ...Components>()
+                {
+                    using Filter = QueryFilter<Filters...>;
+                    if constexpr (ArchetypeManager::HasSparse<Components...>)
+                    {
+                        IterateSparse<Filter, Components...>(lambda);
+                    }
+                    else
+                    {
+                        using LookupCache = ArchetypeManager::FilteredLookupCache<Filter, Components...>;
+#if SECS_ENABLE_STATS
+                        const ScopedTimer timer(ArchetypeManager::Cache(LookupCache::slot).stats.time);
+#endif
+                        const Vector<Index>& active = LookupCache::Update();
+                        LookupCache::CountIteration();
+
+                        auto visit = [this, lambda](Index first, Index count)
+                        {
+                            [this, lambda, first, count](Components* ...componentArray)
+                            {
+                                Index end = first + count;
+                                Index visited = 0;
+                                for (currentRow = first; !stop && currentRow < end && currentRow < currentManager->size; currentRow++)
+                                {
+                                    if (RowMatches<Filter>(*currentManager, currentRow))
+                                    {
+                                        lambda(componentArray...);
+                                        visited++;
+                                    }
+                                    ((componentArray = Filter::Next(componentArray)), ...);
+                                }
+                                LookupCache::CountVisited(visited);
+                            }(currentManager->template GetComponent<Components>(first) ...);
+                        };
+
+                        for (size_t managerIndex : active)
+                        {
+                            if (stop) break;
+
+                            currentManager = &ArchetypeManager::Get(managerIndex);
+                            EachVisitedSpan<Filter, Components...>(visit);
+                        }
+
+                        if constexpr (Filter::HasChanged) { lastChangeTick = ArchetypeManager::storage->changeTick++; }
+                    }
+                });
+                currentRow = InvalidIndex;
+            }
+
+            /**
+             * @brief Iterate over contiguous spans of entities with specified component types.
+             * 
+             * @details
+             * Instead of being called once per entity, the lambda receives the number of
+             * entities in a span followed by pointers to the first element of each component
+             * column. Entity `i` of the span owns `pos[i]`, `vel[i]` and so on. With contiguous
+             * storage a span covers a whole archetype, with SECS_CHUNK_SIZE it covers one chunk.
+             * 
+             * Handing the loop to the lambda lets the compiler unroll and vectorize it,
+             * which an opaque per-entity callback prevents. StopIteration() takes effect
+             * between spans and GetCurrentEntity() is not available during the call.
+             * 
+             * Filters work as in Iterate(), optional components missing from an archetype are
+             * passed as nullptr for the whole span. Tags have no column, their pointer refers to
+             * a single shared instance and must not be indexed. With a Changed<> filter spans are
+             * further split into blocks of SECS_CHANGE_BLOCK_ROWS rows.
+             * 
+             * @tparam Filters Optional With, Without, Optional and Changed filters refining the visited entities.
+             * @tparam Lambda The lambda function to execute for each span.
+             * @param lambda The lambda function taking a `size_t` count followed by pointers to the component types.
+             * 
+             * @par Example Usage:
+             * @code{.cpp}
+             * World::EntityIterator it;
+             * it.IterateChunks([](size_t count, Position* pos, Velocity* vel) {
+             *     for (size_t i = 0; i < count; ++i) {
+             *         pos[i].x += vel[i].dx;
+             *         pos[i].y += vel[i].dy;
+             *     }
+             * });
+             * @endcode
+             */
+            template <typename... Filters, typename Lambda>
+            void IterateChunks(Lambda lambda)
+            {
+                stop = false;
+                using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+                LambdaTraits::CallWithTypes([this, &lambda]<typename ...Components>()
+                {
+                    static_assert(!ArchetypeManager::HasSparse<Components...>,
+                        "IterateChunks() hands out column spans, sparse components cannot be parameters, see SECS::SparseStorage");
+
+                    using Filter = QueryFilter<Filters...>;
+                    using LookupCache = ArchetypeManager::FilteredLookupCache<Filter, Components...>;
+#if SECS_ENABLE_STATS
+                    const ScopedTimer timer(ArchetypeManager::Cache(LookupCache::slot).stats.time);
+#endif
+                    const Vector<Index>& active = LookupCache::Update();
+                    LookupCache::CountIteration();
+
+                    auto visit = [this, &lambda](Index first, Index count)
+                    {
+                        if constexpr (Filter::HasSparse)
+                        {
+                            // The span is split around the rows sparse filter terms exclude
+                            const Index end = first + count;
+                            Index row = first;
+                            while (!stop && row < end)
+                            {
+                                while (row < end && !RowMatches<Filter>(*currentManager, row)) { row++; }
+                                const Index run = row;
+                                while (row < end && RowMatches<Filter>(*currentManager, row)) { row++; }
+                                if (row == run) { break; }
+
+                                lambda(size_t(row - run), currentManager->template GetComponent<Components>(run) ...);
+                                LookupCache::CountVisited(row - run);
+                            }
+                        }
+                        else
+                        {
+                            lambda(size_t(count), currentManager->template GetComponent<Components>(first) ...);
+                            LookupCache::CountVisited(count);
+                        }
+                    };
+
+                    for (size_t managerIndex : active)
+                    {
+                        if (stop) break;
+
+                        currentManager = &ArchetypeManager::Get(managerIndex);
+                        EachVisitedSpan<Filter, Components...>(visit);
+                    }
+
+                    if constexpr (Filter::HasChanged) { lastChangeTick = ArchetypeManager::storage->changeTick++; }
+                });
+                currentManager = nullptr;
+            }
+
+            /**
+             * @brief Iterate over entities with several lambda functions in a single pass.
+             * 
+             * @details
+             * Every archetype matched by any of the lambdas is visited once. Its rows are
+             * processed in blocks of SECS_FUSED_ROWS: each lambda matching the archetype
+             * runs over the whole block, in argument order, before the next block starts.
+             * Columns shared by the lambdas are thus loaded into the cache once instead of
+             * once per lambda, as separate Iterate() calls would.
+             * 
+             * Each entity sees the lambdas in argument order, like with consecutive Iterate()
+             * calls, but a lambda may run on a block before the previous lambda reached later
+             * blocks. Lambdas that read other entities through captured state may observe a
+             * different order than with separate iterations.
+             * 
+             * The filters apply to every lambda. Changed<> filters are not supported.
+             * StopIteration() ends the whole pass and GetCurrentEntity() refers to the entity
+             * the running lambda was called for.
+             * 
+             * @tparam Filters Optional With, Without and Optional filters refining the visited entities.
+             * @tparam Lambdas The lambda function types, at most 32.
+             * @param lambdas The lambda functions taking pointers to the component types.
+             * 
+             * @par Example Usage:
+             * @code{.cpp}
+             * World::EntityIterator it;
+             * it.IterateFused(
+             *     [](Position* pos, const Velocity* vel) { pos->x += vel->dx; pos->y += vel->dy; },
+             *     [](Position* pos) { pos->x = (pos->x < 0.0f) ? 0.0f : pos->x; },
+             *     [](Sprite* sprite) { sprite->frame++; });
+             * @endcode
+             */
+            template <typename... Filters, typename... Lambdas>
+            void IterateFused(Lambdas... lambdas)
+            {
+                using Filter = QueryFilter<Filters...>;
+                static_assert(sizeof...(Lambdas) > 0 && sizeof...(Lambdas) <= 32, "IterateFused() takes 1 to 32 lambdas");
+                static_assert(!Filter::HasChanged,
+                    "Changed<> filters need a separate iteration per lambda, use EntityIterator::Iterate()");
+
+                stop = false;
+                std::tuple<Lambdas&...> fused(lambdas...);
+                [this, &fused]<size_t... I>(std::index_sequence<I...>)
+                {
+                    (VisitFused<Filter, I>(fused), ...);
+                }(std::index_sequence_for<Lambdas...>());
+                currentRow = InvalidIndex;
+            }
+
+            /**
+             * @brief Iterate over entities parents first, passing each one a component of its parent.
+             * 
+             * @details
+             * The first lambda parameter is a const pointer to a component of the entity's
+             * parent, nullptr for roots and parents lacking it; the following parameters are
+             * the entity's components, as with Iterate(). Entities are visited by increasing
+             * depth, so the value a parent passes down was already updated in the same call.
+             * 
+             * World::SortHierarchy() runs first, after which every depth of every archetype
+             * is one contiguous range of rows. Each depth is visited in a linear pass over
+             * the columns, the only other load per entity being its parent's component,
+             * shared by consecutive siblings.
+             * 
+             * Entities without ChildOf are roots. Structural changes are not allowed during
+             * the call, record them in a CommandBuffer.
+             * 
+             * @tparam Filters Optional With, Without and Optional filters refining the visited entities.
+             * @tparam Lambda The lambda function type.
+             * @param lambda The lambda function taking a const pointer to the parent's component followed by
+             *               pointers to the entity's component types.
+             * @return bool Returns false without visiting anything if World::SortHierarchy() failed.
+             * 
+             * @par Example Usage:
+             * @code{.cpp}
+             * World::EntityIterator it;
+             * it.IterateHierarchy([](const Transform* parent, const LocalTransform* local, Transform* world) {
+             *     *world = parent ? Combine(*parent, *local) : Transform(*local);
+             * });
+             * @endcode
+             */
+            template <typename... Filters, typename Lambda>
+            bool IterateHierarchy(Lambda lambda)
+            {
+                if (!World::SortHierarchy()) { return false; }
+
+                stop = false;
+                using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+                LambdaTraits::CallWithTypes([this, &lambda]<typename Inherited, typename ...Components>()
+                {
+                    static_assert(std::is_const_v<Inherited>, "The parent's component is read-only, take it as a const pointer");
+                    static_assert(sizeof...(Components) > 0, "IterateHierarchy() lambdas take at least one component of the entity");
+                    static_assert(!ArchetypeManager::HasSparse<Inherited, Components...>,
+                        "IterateHierarchy() walks columns by depth, sparse components cannot be parameters, see SECS::SparseStorage");
+
+                    using Filter = QueryFilter<Filters...>;
+                    static_assert(!Filter::HasChanged, "Changed<> filters are not supported by IterateHierarchy()");
+                    using LookupCache = ArchetypeManager::FilteredLookupCache<Filter, Components...>;
+                    const Vector<Index>& active = LookupCache::Update();
+                    LookupCache::CountIteration();
+
+                    // First row of each archetype not visited yet, nested iterations stack after them
+                    Vector<Index>& cursors = ArchetypeManager::storage->scratch;
+                    const size_t base = cursors.size();
+                    cursors.resize(base + active.size(), 0);
+
+                    bool remaining = !active.empty();
+                    for (Index depth = 0; remaining && !stop; ++depth)
+                    {
+                        remaining = false;
+                        for (size_t i = 0; i < active.size() && !stop; ++i)
+                        {
+                            currentManager = &ArchetypeManager::Get(active[i]);
+                            const Index begin = cursors[base + i];
+                            const Index end = currentManager->id.Contains(ArchetypeManager::Helper<ChildOf>::id) ?
+                                DepthEnd(begin, depth) : currentManager->size;
+
+                            cursors[base + i] = end;
+                            remaining = remaining || end < currentManager->size;
+                            VisitHierarchy<Filter, Inherited, Components...>(lambda, begin, end);
+                        }
+                    }
+                    cursors.resize(base);
+                });
+                currentRow = InvalidIndex;
+                return true;
+            }
+
+        private:
+            /**
+             * @brief Find the end of the rows of a depth in the current archetype, sorted by SortHierarchy().
+             * @param begin The first row of the depth.
+             * @param depth The depth.
+             * @return One past the last row whose depth is not greater than depth.
+             */
+            Index DepthEnd(Index begin, Index depth) const
+            {
+                Index end = begin;
+                currentManager->EachSpan(begin, currentManager->size, [this, &end, depth](Index first, Index count)
+                {
+                    // A previous span ended the depth
+                    if (end != first) { return; }
+
+                    const ChildOf* links = currentManager->GetComponent<ChildOf>(first);
+                    Index row = 0;
+                    while (row < count && links[row].depth <= depth) { row++; }
+                    end = first + row;
+                });
+                return end;
+            }
+
+            /**
+             * @brief Visit a range of rows of the current archetype for IterateHierarchy().
+             * @tparam Filter The QueryFilter of the iteration.
+             * @tparam Inherited The component type read from the parent of each entity.
+             * @tparam Components The component types of the entity.
+             * @param lambda The lambda function to execute for each entity.
+             * @param begin The first row of the range.
+             * @param end One past the last row of the range.
+             */
+            template <typename Filter, typename Inherited, typename... Components, typename Lambda>
+            void VisitHierarchy(Lambda& lambda, Index begin, Index end)
+            {
+                const bool linked = currentManager->id.Contains(ArchetypeManager::Helper<ChildOf>::id);
+                currentManager->EachSpan(begin, end, [this, &lambda, linked](Index first, Index count)
+                {
+                    if (stop) { return; }
+                    if constexpr (ArchetypeManager::WritesTracked<Components...>)
+                    {
+                        currentManager->MarkChanged(first, count, ArchetypeManager::WrittenId<Components...>());
+                    }
+
+                    [this, &lambda, first, count](const ChildOf* links, Components* ...componentArray)
+                    {
+                        Index parentRecord = InvalidIndex;
+                        Inherited* inherited = nullptr;
+                        const Index last = first + count;
+                        Index visited = 0;
+                        for (currentRow = first; !stop && currentRow < last; currentRow++)
+                        {
+                            // Siblings are sorted next to each other and share the lookup
+                            if (links)
+                            {
+                                if (links->parent.recordIndex != parentRecord)
+                                {
+                                    parentRecord = links->parent.recordIndex;
+                                    inherited = World::ComponentOf<Inherited>(links->parent);
+                                }
+                                links++;
+                            }
+
+                            if (RowMatches<Filter>(*currentManager, currentRow))
+                            {
+                                lambda(inherited, componentArray...);
+                                visited++;
+                            }
+                            ((componentArray = Filter::Next(componentArray)), ...);
+                        }
+                        ArchetypeManager::FilteredLookupCache<Filter, Components...>::CountVisited(visited);
+                    }(linked ? currentManager->GetComponent<ChildOf>(first) : nullptr,
+                        currentManager->template GetComponent<Components>(first)...);
+                });
+            }
+
+            /**
+             * @brief Iterate over the entities of a query taking sparse components.
+             * @details The smallest sparse set required by the query drives the walk, or the matched
+             * archetypes when every sparse component of the query is optional. The records of the
+             * set are copied first and each one is checked again when reached, so changes the lambda
+             * makes to the set can neither skip an entity nor visit one twice.
+             * @tparam Filter The QueryFilter of the iteration.
+             * @tparam Components The component types of the lambda parameters.
+             * @param lambda The lambda function to execute for each entity.
+             */
+            template <typename Filter, typename... Components, typename Lambda>
+            void IterateSparse(const Lambda& lambda)
+            {
+                static_assert(!Filter::HasChanged, "Changed<> filters cannot be combined with sparse components");
+
+                using LookupCache = ArchetypeManager::FilteredLookupCache<Filter, Components...>;
+#if SECS_ENABLE_STATS
+                const ScopedTimer timer(ArchetypeManager::Cache(LookupCache::slot).stats.time);
+#endif
+                // The matched archetypes are resolved even when a sparse set drives the walk, so that the run counts them
+                const Vector<Index>& active = LookupCache::Update();
+                LookupCache::CountIteration();
+
+                const SparseSet* smallest = nullptr;
+                ((Filter::template IsOptional<Components> ? void() : ArchetypeManager::KeepSmallerSparse<Components>(smallest)), ...);
+                Filter::KeepSmallerSparse(smallest);
+
+                const Component::BinaryId components = ArchetypeManager::ColumnsId<Components...>();
+                size_t visited = 0;
+                auto visit = [this, &lambda, components, &visited](EntityRecord& record)
+                {
+                    ArchetypeManager& manager = ArchetypeManager::Get(record.archetype);
+                    const Index recordIndex = record.GetIndex();
+                    if (!Filter::Matches(manager.id, components) || !Filter::MatchesSparse(recordIndex)) { return; }
+                    if (!((Filter::template IsOptional<Components> || ArchetypeManager::HoldsSparse<Components>(recordIndex)) && ...)) { return; }
+
+                    currentManager = &manager;
+                    currentRow = record.row;
+                    if constexpr (ArchetypeManager::WritesTracked<Components...>)
+                    {
+                        manager.MarkChanged(record.row, 1, ArchetypeManager::WrittenId<Components...>());
+                    }
+                    lambda(ArchetypeManager::Fetch<Components>(manager, record)...);
+                    visited++;
+                };
+
+                if (smallest)
+                {
+                    // Nested walks stack their records after those of this one
+                    Vector<Index>& walk = ArchetypeManager::storage->scratch;
+                    const size_t base = walk.size();
+                    walk.resize(base + smallest->Size());
+                    for (size_t dense = 0; dense < smallest->Size(); ++dense)
+                    {
+                        walk[base + dense] = smallest->Entity(dense);
+                    }
+
+                    for (size_t i = base; !stop && i < walk.size(); ++i)
+                    {
+                        // Entities removed from the set by the lambda are skipped
+                        if (smallest->Find(walk[i]) == InvalidIndex) { continue; }
+                        visit(EntityRecord::Get(walk[i]));
+                    }
+                    walk.resize(base);
+                }
+                else
+                {
+                    for (Index managerIndex : active)
+                    {
+                        ArchetypeManager& manager = ArchetypeManager::Get(managerIndex);
+                        for (Index row = 0; !stop && row < manager.size; ++row)
+                        {
+                            visit(EntityRecord::Get(manager.RecordIndex(row)));
+                        }
+                        if (stop) { break; }
+                    }
+                }
+                LookupCache::CountVisited(visited);
+                currentManager = nullptr;
+            }
+
+            /**
+             * @brief Check whether the current archetype is visited by a lambda of a fused iteration.
+             * @tparam Filter The QueryFilter of the iteration.
+             * @tparam Lambda The lambda function type.
+             * @return true if the lambda matches the archetype.
+             */
+            template <typename Filter, typename Lambda>
+            bool FusedMatches() const
+            {
+                using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+                return LambdaTraits::CallWithTypes([this]<typename ...Components>()
+                {
+                    return Filter::Matches(currentManager->id, ArchetypeManager::Helper<Components...>::id);
+                });
+            }
+
+            /**
+             * @brief Visit the archetypes of a fused iteration that are first matched by one of its lambdas.
+             * @details Archetypes also matched by an earlier lambda were already visited with it.
+             * @tparam Filter The QueryFilter of the iteration.
+             * @tparam K The index of the lambda whose matched archetypes are visited.
+             * @param fused The lambdas of the iteration.
+             */
+            template <typename Filter, size_t K, typename... Lambdas>
+            void VisitFused(std::tuple<Lambdas&...>& fused)
+            {
+                using LambdaTraits = LambdaUtil<decltype(&std::tuple_element_t<K, std::tuple<Lambdas...>>::operator())>;
+                const Vector<Index>& active = *LambdaTraits::CallWithTypes([]<typename ...Components>()
+                {
+                    using LookupCache = ArchetypeManager::FilteredLookupCache<Filter, Components...>;
+                    const Vector<Index>& active = LookupCache::Update();
+                    LookupCache::CountIteration();
+                    return &active;
+                });
+
+                for (Index managerIndex : active)
+                {
+                    if (stop) { return; }
+
+                    currentManager = &ArchetypeManager::Get(managerIndex);
+                    const uint32_t matched = [this]<size_t... I>(std::index_sequence<I...>)
+                    {
+                        return (uint32_t(0) | ... | (uint32_t(FusedMatches<Filter, Lambdas>()) << I));
+                    }(std::index_sequence_for<Lambdas...>());
+
+                    if (matched & ((uint32_t(1) << K) - 1)) { continue; }
+
+                    const size_t size = currentManager->size;
+                    for (size_t begin = 0; !stop && begin < size; begin += SECS_FUSED_ROWS)
+                    {
+                        const size_t end = (begin + SECS_FUSED_ROWS < size) ? begin + SECS_FUSED_ROWS : size;
+                        [this, &fused, matched, begin, end]<size_t... I>(std::index_sequence<I...>)
+                        {
+                            ((((matched >> I) & 1) ? FusedBlock<Filter>(std::get<I>(fused), Index(begin), Index(end)) : void()), ...);
+                        }(std::index_sequence_for<Lambdas...>());
+                    }
+                }
+            }
+
+            /**
+             * @brief Run one lambda of a fused iteration on a block of rows of the current archetype.
+             * @tparam Filter The QueryFilter of the iteration.
+             * @tparam Lambda The lambda function type.
+             * @param lambda The lambda function.
+             * @param begin The first row of the block.
+             * @param end One past the last row of the block.
+             */
+            template <typename Filter, typename Lambda>
+            void FusedBlock(Lambda& lambda, Index begin, Index end)
+            {
+                using LambdaTraits = LambdaUtil<decltype(&Lambda::operator())>;
+                LambdaTraits::CallWithTypes([this, &lambda, begin, end]<typename ...Components>()
+                {
+                    currentManager->EachSpan(begin, end, [this, &lambda](Index first, Index count)
+                    {
+                        if (stop) { return; }
+                        if constexpr (ArchetypeManager::WritesTracked<Components...>)
+                        {
+                            currentManager->MarkChanged(first, count, ArchetypeManager::WrittenId<Components...>());
+                        }
+
+                        [this, &lambda, first, count](Components* ...componentArray)
+                        {
+                            Index end = first + count;
+                            Index visited = 0;
+                            for (currentRow = first; !stop && currentRow < end && currentRow < currentManager->size; currentRow++)
+                            {
+                                if (RowMatches<Filter>(*currentManager, currentRow))
+                                {
+                                    lambda(componentArray...);
+                                    visited++;
+                                }
+                                ((componentArray = Filter::Next(componentArray)), ...);
+                            }
+                            ArchetypeManager::FilteredLookupCache<Filter, Components...>::CountVisited(visited);
+                        }(currentManager->template GetComponent<Components>(first) ...);
+                    });
+                });
+            }
+
+            /**
+             * @brief Call a function on each span of the current archetype an iteration visits.
+             * @details Spans are split into change blocks and filtered when the query has a Changed<>
+             * filter. The visited rows of written tracked components are marked as changed.
+             * @tparam Filter The QueryFilter of the iteration.
+             * @tparam Components The component types of the lambda.
+             * @param visit The function called with the first row and the row count of each visited span.
+             */
+            template <typename Filter, typename... Components, typename Visit>
+            void EachVisitedSpan(Visit& visit)
+            {
+                if constexpr (Filter::HasChanged)
+                {
+                    const Component::BinaryId changed = Filter::ChangedId();
+                    currentManager->EachChangeBlock(0, currentManager->size, [this, &visit, changed](Index first, Index count)
+                    {
+                        if (stop || !currentManager->ChangedSince(first, changed, lastChangeTick)) { return; }
+                        if constexpr (ArchetypeManager::WritesTracked<Components...>)
+                        {
+                            currentManager->MarkChanged(first, count, ArchetypeManager::WrittenId<Components...>());
+                        }
+                        visit(first, count);
+                    });
+                }
+                else
+                {
+                    currentManager->EachSpan([this, &visit](Index first, Index count)
+                    {
+                        if (stop) { return; }
+                        if constexpr (ArchetypeManager::WritesTracked<Components...>)
+                        {
+                            currentManager->MarkChanged(first, count, ArchetypeManager::WrittenId<Components...>());
+                        }
+                        visit(first, count);
+                    });
+                }
+            }
+        };
+
+    private:
+        /**
+         * @brief Slot of a resource type in the resource table of every world.
+         * @details Slots are handed out to every used resource type during static initialization.
+         * @tparam T The resource type.
+         */
+        template <typename T>
+        struct ResourceSlot
+        {
+            static inline const size_t slot = resourceSlots++;
+        };
+
+        /**
+         * @brief Destroy an instance of a resource type and release its storage.
+         * @tparam T The resource type.
+         * @param instance The instance.
+         */
+        template <typename T>
+        static void ReleaseResource(void* instance)
+        {
+            static_cast<T*>(instance)->~T();
+            Memory::Deallocate(static_cast<T*>(instance), 1);
+        }
+
+        /**
+         * @brief Get the record of an entity if the reference to it is still valid.
+         * @param entity The entity.
+         * @return A pointer to the record, or nullptr if the entity is invalid or destroyed.
+         */
+        static const EntityRecord* RecordOf(const EntityReference& entity)
+        {
+            if (entity.recordIndex == InvalidIndex) { return nullptr; }
+
+            const EntityRecord& record = EntityRecord::Get(entity.recordIndex);
+            return entity.Holds(record) ? &record : nullptr;
+        }
+
+        /**
+         * @brief Get a component of an entity if the reference to it is still valid.
+         * @tparam T The component type.
+         * @param entity The entity.
+         * @return A pointer to the component, or nullptr if the entity is invalid, destroyed or lacks it.
+         */
+        template <typename T>
+        static T* ComponentOf(const EntityReference& entity)
+        {
+            const EntityRecord* record = RecordOf(entity);
+            return record ? ArchetypeManager::Get(record->archetype).GetComponent<T>(record->row) : nullptr;
+        }
+
+        /**
+         * @brief Get the parent link of an entity.
+         * @param entity The entity.
+         * @return A pointer to its ChildOf component, or nullptr for roots and invalid entities.
+         */
+        static ChildOf* LinkOf(const EntityReference& entity)
+        {
+            return ComponentOf<ChildOf>(entity);
+        }
+
+        /**
+         * @brief Count the valid ancestors of a linked entity.
+         * @details The walk is bounded by the number of records, so links written by hand into a cycle
+         * cannot hang it.
+         * @param link The ChildOf component of the entity.
+         * @return The depth of the entity, 0 if its parent is no longer valid.
+         */
+        static Index DepthOf(const ChildOf& link)
+        {
+            Index depth = 0;
+            for (const ChildOf* current = &link; current && RecordOf(current->parent) && depth < EntityRecord::storage->last;
+                current = LinkOf(current->parent))
+            {
+                depth++;
+            }
+            return depth;
+        }
+
+        /**
+         * @brief Register a typed hook for a component type.
+         * @tparam T The component type.
+         * @param hook The hook, or nullptr to unregister it.
+         * @param removed true for the OnRemove hook, false for the OnAdd hook.
+         */
+        template <typename T>
+        static void SetHook(void (*hook)(EntityReference, T*), bool removed)
+        {
+            using Type = std::remove_cv_t<T>;
+            static_assert(!SparseStorage<Type>::value, "Sparse components do not support hooks");
+            Component::Hook erased;
+            if (hook)
+            {
+                erased.invoke = &InvokeHook<T>;
+                erased.callback = reinterpret_cast<Component::HookCallback>(hook);
+            }
+
+            (void)Component::IdBinary<Type>;
+            Component::SetHook(Component::Id<Type>, erased, removed);
+        }
+
+        /**
+         * @brief Call a type-erased hook with its real signature.
+         * @tparam T The component type of the hook.
+         * @param callback The hook registered through SetHook().
+         * @param entity The entity gaining or losing the component.
+         * @param component The component, nullptr for tags.
+         */
+        template <typename T>
+        static void InvokeHook(Component::HookCallback callback, const EntityReference& entity, void* component)
+        {
+            reinterpret_cast<void (*)(EntityReference, T*)>(callback)(entity, static_cast<T*>(component));
+        }
+
+        /**
+         * @brief Run the OnAdd hooks of a range of newly created rows.
+         * @param manager The archetype holding the rows.
+         * @param first The first row of the range.
+         * @param count The number of rows.
+         */
+        static void RunCreationHooks(ArchetypeManager& manager, Index first, Index count)
+        {
+            if (!(manager.id & Component::AddHookMask)) { return; }
+
+            for (Index i = 0; i < count; ++i)
+            {
+                EntityReference::RunHooks(EntityRecord::Get(manager.RecordIndex(first + i)), manager.id, false);
+            }
+        }
+
+        /**
+         * @brief Get references to the entities of a range of rows.
+         * @param manager The archetype holding the rows.
+         * @param first The first row of the range.
+         * @param count The number of rows.
+         * @param references The array receiving the references, may be nullptr.
+         */
+        static void GetReferences(ArchetypeManager& manager, Index first, Index count, EntityReference* references)
+        {
+            if (!references) { return; }
+
+            for (Index i = 0; i < count; ++i)
+            {
+                references[i] = EntityReference(EntityRecord::Get(manager.RecordIndex(first + i)));
+            }
+        }
+
+        /**
+         * @brief The state shared by the jobs of one dispatch.
+         * @tparam Owner The type running the rows of the jobs, the lambda of IterateParallel() or a Schedule.
+         */
+        template <typename Owner>
+        struct JobContext
+        {
+            Owner* owner;
+            const ArchetypeManager::Job* jobs;
+            CurrentWorld world;     /**< World of the dispatch, made current on the workers. */
+        };
+
+        /**
+         * @brief Mark every row of an archetype as written by a dispatch.
+         * @details Marked up front, workers never write to the change tick table.
+         * @tparam Components The component types of the lambda.
+         * @param manager The archetype the dispatch visits.
+         */
+        template <typename... Components>
+        static void MarkDispatched(ArchetypeManager& manager)
+        {
+            if constexpr (ArchetypeManager::WritesTracked<Components...>)
+            {
+                manager.MarkChanged(0, manager.size, ArchetypeManager::WrittenId<Components...>());
+            }
+        }
+
+        /**
+         * @brief Split archetypes into the jobs of a dispatch, of at most SECS_JOB_ROWS rows each.
+         * @details The jobs are counted before the job list of the world is filled, so the list
+         * only reallocates when a dispatch needs more jobs than every previous one, to the exact
+         * number. Repeated dispatches over the same entities therefore never allocate.
+         * @param archetypes Callable taking a split function, which it calls with every archetype
+         *                   to split and the mask of the Schedule systems running on it. It is
+         *                   called twice and must visit the same archetypes both times.
+         * @return The job list of the world, valid until the next dispatch, which cannot start
+         *         before this one completed since the world is locked meanwhile.
+         */
+        template <typename Archetypes>
+        static const Vector<ArchetypeManager::Job>& SplitJobs(Archetypes archetypes)
+        {
+            size_t count = 0;
+            archetypes([&count](const ArchetypeManager& manager, uint32_t)
+            {
+                count += (size_t(manager.size) + SECS_JOB_ROWS - 1) / SECS_JOB_ROWS;
+            });
+
+            Vector<ArchetypeManager::Job>& jobs = ArchetypeManager::storage->jobs;
+            jobs.clear();
+            jobs.reserve(count);
+            archetypes([&jobs](ArchetypeManager& manager, uint32_t systems)
+            {
+                for (size_t first = 0; first < manager.size; first += SECS_JOB_ROWS)
+                {
+                    size_t end = first + SECS_JOB_ROWS;
+                    end = (end < manager.size) ? end : manager.size;
+                    jobs.push_back(ArchetypeManager::Job{ &manager, static_cast<Index>(first), static_cast<Index>(end), systems });
+                }
+            });
+            return jobs;
+        }
+
+        /**
+         * @brief Hand the jobs of a dispatch to the executor, with the world locked against structural changes.
+         * @tparam Owner The type running the rows of the jobs.
+         * @tparam Body The function running the rows of one job.
+         * @param owner The object passed to Body.
+         * @param jobs The jobs, from SplitJobs().
+         */
+        template <typename Owner, void (*Body)(Owner& owner, const ArchetypeManager::Job& job)>
+        static void Dispatch(Owner& owner, const Vector<ArchetypeManager::Job>& jobs)
+        {
+            if (jobs.empty()) { return; }
+
+            JobContext<Owner> context{ &owner, jobs.data(), CurrentWorld::Get() };
+            ArchetypeManager::storage->structuralLocks++;
+            Executor::Run(jobs.size(), &RunJob<Owner, Body>, &context);
+            ArchetypeManager::storage->structuralLocks--;
+        }
+
+        /**
+         * @brief Run one job of a dispatch.
+         * @tparam Owner The type running the rows of the jobs.
+         * @tparam Body The function running the rows of one job.
+         * @param context The JobContext of the dispatch.
+         * @param jobIndex The index of the job to run.
+         */
+        template <typename Owner, void (*Body)(Owner& owner, const ArchetypeManager::Job& job)>
+        static void RunJob(void* context, size_t jobIndex)
+        {
+            const JobContext<Owner>& jobContext = *static_cast<const JobContext<Owner>*>(context);
+
+            // Workers may run on other threads, the job must see the world of the dispatch
+            const CurrentWorld previous = CurrentWorld::Get();
+            jobContext.world.Set();
+            Body(*jobContext.owner, jobContext.jobs[jobIndex]);
+            previous.Set();
+        }
+
+        /**
+         * @brief Run the lambda of an IterateParallel() dispatch on the rows of one job.
+         * @tparam Filter The QueryFilter of the dispatch.
+         * @tparam Lambda The lambda function type.
+         * @tparam Components The component types of the lambda.
+         * @param lambda The lambda function.
+         * @param job The job.
+         */
+        template <typename Filter, typename Lambda, typename... Components>
+        static void RunRows(Lambda& lambda, const ArchetypeManager::Job& job)
+        {
+            job.manager->EachSpan(job.begin, job.end, [&job, &lambda](Index first, Index count)
+            {
+                [&job, &lambda, first, count](Components* ...componentArray)
+                {
+                    for (Index row = first; row < first + count; ++row)
+                    {
+                        if (RowMatches<Filter>(*job.manager, row)) { lambda(componentArray...); }
+                        ((componentArray = Filter::Next(componentArray)), ...);
+                    }
+                }(job.manager->template GetComponent<Components>(first) ...);
+            });
+        }
+
+        /**
+         * @brief Check the sparse With and Without filter terms of a query on one row.
+         * @tparam Filter The QueryFilter of the query.
+         * @param manager The archetype holding the row.
+         * @param row The row index.
+         * @return true if the entity of the row is visited, always for queries without sparse filter terms.
+         */
+        template <typename Filter>
+        static bool RowMatches(ArchetypeManager& manager, Index row)
+        {
+            if constexpr (Filter::HasSparse)
+            {
+                return Filter::MatchesSparse(manager.RecordIndex(row));
+            }
+            else
+            {
+                (void)manager;
+                (void)row;
+                return true;
+            }
+        }
     };
 };
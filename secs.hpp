@@ -71,11 +71,24 @@
 #endif
 
 // Core ECS types
+#include "impl/Config.hpp"
+#include "impl/Allocator.hpp"
+#include "impl/Executor.hpp"
+#include "impl/BitSet.hpp"
+#include "impl/Stats.hpp"
+#include "impl/SparseSet.hpp"
 #include "impl/Archetype.hpp"
 #include "impl/Component.hpp"
 #include "impl/EntityRecord.hpp"
 #include "impl/EntityReference.hpp"
+#include "impl/EntityHandle.hpp"
+#include "impl/View.hpp"
+#include "impl/Hierarchy.hpp"
+#include "impl/Query.hpp"
 #include "impl/World.hpp"
+#include "impl/CommandBuffer.hpp"
+#include "impl/Snapshot.hpp"
+#include "impl/Schedule.hpp"
 
 /**
  * @namespace SECS
@@ -88,6 +101,8 @@
  * Key classes:
  * - SECS::World: Main ECS interface for entity creation and system iteration
  * - SECS::EntityReference: Handle to an entity for component access and manipulation
+ * - SECS::EntityHandle: Entity identity packed into 32 bits
+ * - SECS::CommandBuffer: Deferred entity creation, destruction and component changes
  * - SECS::Component: Base functionality for component type management
  * 
  * @par Design Philosophy:
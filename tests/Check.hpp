@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * @file Check.hpp
+ * @brief Checking helpers shared by the SECS test programs
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * Every test program counts its failed checks in one counter, runs each case
+ * through Run() and returns a non-zero status from main() if any check failed.
+ * A program configuring SECS, e.g. through SECS_ALLOCATOR, defines the macros
+ * before including this header.
+ *
+ * @par Example:
+ * ```cpp
+ * int main()
+ * {
+ *     Run("create", []
+ *     {
+ *         EntityReference entity = World::CreateEntity([](Value* value) { value->x = 1; });
+ *         CHECK(Read(entity) == 1);
+ *     });
+ *     return failures ? 1 : 0;
+ * }
+ * ```
+ */
+
+#include <stdio.h>
+
+#include <secs.hpp>
+
+using namespace SECS;
+
+/**
+ * @brief Component read by Read().
+ */
+struct Value { int x; };
+
+/**
+ * @brief Number of failed checks so far.
+ */
+static int failures = 0;
+
+/**
+ * @brief Print the condition and count a failure if it does not hold.
+ */
+#define CHECK(condition) \
+    do { if (!(condition)) { printf("  %s:%d: %s\n", __FILE__, __LINE__, #condition); failures++; } } while (0)
+
+/**
+ * @brief Run a case in a fresh world.
+ * @param name The name printed for the case.
+ * @param body The case.
+ */
+template <typename Body>
+static void Run(const char* name, Body body)
+{
+    const int before = failures;
+    {
+        World world;
+        World::Scope scope(world);
+        body();
+    }
+    printf("%-32s %s\n", name, failures == before ? "ok" : "FAILED");
+}
+
+/**
+ * @brief Read the value of an entity.
+ * @return The value, or -1 if the entity cannot be accessed.
+ */
+[[maybe_unused]] static int Read(EntityReference entity)
+{
+    int x = -1;
+    entity.Access([&x](const Value* value) { x = value->x; });
+    return x;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file arena.cpp
+ * @brief Regression checks of SECS running on a static arena
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * ArenaAllocator only takes back its most recent allocation, so any temporary
+ * buffer SECS allocates and frees per call shows up as arena growth. Each case
+ * repeats an operation over the same entities and checks that the arena stops
+ * growing once the first call sized the storage the operation keeps.
+ *
+ * - **parallel dispatch**: World::IterateParallel() over several jobs
+ * - **schedule**: Schedule::Run() of two stages over several jobs
+ * - **sparse walk**: EntityIterator::Iterate() of a sparse component, nested
+ * - **hierarchy**: relinking entities, then EntityIterator::IterateHierarchy()
+ *   sorting the rows again
+ */
+
+#define SECS_ALLOCATOR ::SECS::ArenaAllocator<4 * 1024 * 1024>
+#include "Check.hpp"
+
+struct Position { float x; };
+struct Velocity { float x; };
+struct Hit { int damage; };
+
+template <> struct SECS::SparseStorage<Hit> : std::true_type {};
+
+/**
+ * @brief Check that repeating an operation does not grow the arena.
+ * @param operation The operation, called once to warm up and then many times.
+ */
+template <typename Operation>
+static void CheckFlat(Operation operation)
+{
+    operation();
+    const size_t used = Allocator::Used();
+    for (int i = 0; i < 100; ++i)
+    {
+        operation();
+    }
+    CHECK(Allocator::Used() == used);
+}
+
+/**
+ * @brief Create entities spread over several jobs of SECS_JOB_ROWS rows.
+ */
+static void CreateMoving()
+{
+    for (size_t i = 0; i < SECS_JOB_ROWS * 3 + 7; ++i)
+    {
+        World::CreateEntity([](Position* pos, Velocity* vel) { pos->x = 0.0f; vel->x = 1.0f; });
+    }
+}
+
+int main()
+{
+    Run("parallel dispatch", []
+    {
+        CreateMoving();
+        CheckFlat([] { World::IterateParallel([](Position* pos, const Velocity* vel) { pos->x += vel->x; }); });
+    });
+
+    Run("schedule", []
+    {
+        CreateMoving();
+        Schedule frame(
+            [](Position* pos, const Velocity* vel) { pos->x += vel->x; },
+            [](const Position* pos, Velocity* vel) { vel->x = -pos->x; });
+        static_assert(decltype(frame)::StageCount == 2);
+        CheckFlat([&frame] { frame.Run(); });
+    });
+
+    Run("sparse walk", []
+    {
+        CreateMoving();
+        World::EntityIterator moving;
+        moving.Iterate([&moving](Position*) { moving.GetCurrentEntity().Add<Hit>(); });
+
+        World::EntityIterator outer;
+        World::EntityIterator inner;
+        CheckFlat([&outer, &inner]
+        {
+            bool nested = false;
+            outer.Iterate([&inner, &nested](const Hit*)
+            {
+                if (nested) { return; }
+                nested = true;
+                inner.Iterate([](Hit* hit) { hit->damage++; });
+            });
+        });
+    });
+
+    Run("hierarchy", []
+    {
+        EntityReference roots[4];
+        EntityReference children[64];
+        for (EntityReference& child : children)
+        {
+            child = World::CreateEntity([](Position* pos, Velocity* vel) { pos->x = 0.0f; vel->x = 1.0f; });
+        }
+        for (EntityReference& root : roots)
+        {
+            root = World::CreateEntity([](Position* pos, Velocity* vel) { pos->x = 0.0f; vel->x = 1.0f; });
+        }
+
+        World::EntityIterator iterator;
+        int shift = 0;
+        CheckFlat([&roots, &children, &iterator, &shift]
+        {
+            // A different parent per frame puts the linked rows out of order
+            shift++;
+            for (int i = 0; i < 64; ++i)
+            {
+                CHECK(World::SetParent(children[i], roots[(i + shift) % 4]));
+            }
+            CHECK(iterator.IterateHierarchy([](const Position* parent, const Velocity* vel, Position* pos)
+            {
+                pos->x = (parent ? parent->x : 0.0f) + vel->x;
+            }));
+        });
+    });
+
+    return failures ? 1 : 0;
+}
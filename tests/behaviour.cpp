@@ -0,0 +1,334 @@
+/**
+ * @file behaviour.cpp
+ * @brief Checks of the documented behaviour of SECS features
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * Each case exercises one feature in a fresh World and checks the guarantees
+ * its documentation gives. The program prints the failed checks and exits
+ * with a non-zero status if there are any, see the Makefile.
+ *
+ * - **command buffer, flush order**: creations, additions and removals are
+ *   applied in recording order, destructions last
+ * - **batched destruction**: destroying scattered rows and the tail of an
+ *   archetype in one flush keeps every other entity with its own components,
+ *   trivial or not
+ * - **changed, ticks**: a Changed<> iteration visits the blocks written since
+ *   the previous one of the same iterator, each iterator keeps its own tick
+ * - **hooks**: OnAdd and OnRemove run once per transition, immediate or
+ *   flushed, see the initialized component and cannot change the structure
+ * - **view, revalidation**: a View keeps reaching its entity when rows move,
+ *   storage grows or the entity changes archetype, and fails once it is gone
+ * - **stats, first run**: the first run of a query counts the empty archetypes
+ *   it matches as skipped, through any iteration
+ * - **parallel, nested dispatch**: IterateParallel() and Schedule::Run() fail
+ *   from the jobs of a running dispatch, which keeps its own jobs
+ */
+
+#define SECS_ENABLE_STATS 1
+#include "Check.hpp"
+
+struct Total { int x; };
+
+/**
+ * @brief Component moved through its own operators, moved-from instances hold -1.
+ */
+struct Moved
+{
+    int x = 0;
+
+    Moved() = default;
+    Moved(Moved&& other) : x(other.x) { other.x = -1; }
+    Moved& operator=(Moved&& other) { x = other.x; other.x = -1; return *this; }
+};
+
+struct Speed { int x; };
+
+template <> struct SECS::TrackChanges<Speed> : std::true_type {};
+
+struct Mark { int x; };
+
+template <> struct SECS::SparseStorage<Mark> : std::true_type {};
+
+/**
+ * @brief Read the total of an entity.
+ * @return The total, or -1 if the entity cannot be accessed or has none.
+ */
+static int ReadTotal(EntityReference entity)
+{
+    int x = -1;
+    entity.Access([&x](const Total* total) { x = total->x; });
+    return x;
+}
+
+int main()
+{
+    Run("command buffer, flush order", []
+    {
+        EntityReference entities[10];
+        for (int i = 0; i < 10; ++i)
+        {
+            entities[i] = World::CreateEntity([i](Value* value) { value->x = i; });
+        }
+
+        // Every entity gets a Total, even ones are destroyed, which comes last
+        CommandBuffer buffer;
+        World::EntityIterator iterator;
+        iterator.Iterate([&buffer, &iterator](const Value* value)
+        {
+            const int x = value->x;
+            EntityReference entity = iterator.GetCurrentEntity();
+            if (x % 2 == 0) { buffer.Destroy(entity); }
+            buffer.Add(entity, [x](Total* total) { total->x = x * 10; });
+            if (x == 0) { buffer.Create([](Value* created) { created->x = 100; }); }
+        });
+        CHECK(!buffer.Empty());
+        CHECK(buffer.Flush());
+        CHECK(buffer.Empty());
+
+        for (int i = 0; i < 10; ++i)
+        {
+            CHECK(Read(entities[i]) == (i % 2 ? i : -1));
+            CHECK(ReadTotal(entities[i]) == (i % 2 ? i * 10 : -1));
+        }
+
+        int count = 0;
+        int sum = 0;
+        iterator.Iterate([&count, &sum](const Value* value) { count++; sum += value->x; });
+        CHECK(count == 6);
+        CHECK(sum == 1 + 3 + 5 + 7 + 9 + 100);
+
+        // The later of an addition and a removal wins
+        buffer.Remove<Total>(entities[1]);
+        buffer.Add<Total>(entities[1]);
+        buffer.Add<Total>(entities[3]);
+        buffer.Remove<Total>(entities[3]);
+        CHECK(buffer.Flush());
+        CHECK(ReadTotal(entities[1]) == 0);
+        CHECK(ReadTotal(entities[3]) == -1);
+        CHECK(Read(entities[3]) == 3);
+    });
+
+    Run("batched destruction", []
+    {
+        static EntityReference entities[100];
+        for (int i = 0; i < 100; ++i)
+        {
+            entities[i] = World::CreateEntity([i](Value* value, Moved* moved) { value->x = i; moved->x = i; });
+        }
+
+        CommandBuffer buffer;
+        int destroyed = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            if (i % 3 == 0 || i >= 95)
+            {
+                buffer.Destroy(entities[i]);
+                destroyed++;
+            }
+        }
+        CHECK(buffer.Flush());
+
+        for (int i = 0; i < 100; ++i)
+        {
+            const bool kept = i % 3 != 0 && i < 95;
+            int x = -1;
+            entities[i].Access([&x](const Value* value, const Moved* moved) { x = (value->x == moved->x) ? value->x : -2; });
+            CHECK(x == (kept ? i : -1));
+        }
+
+        int count = 0;
+        World::EntityIterator iterator;
+        iterator.Iterate([&count](const Value* value, const Moved* moved) { count += value->x == moved->x; });
+        CHECK(count == 100 - destroyed);
+    });
+
+    Run("hooks", []
+    {
+        static int added = 0;
+        static int removed = 0;
+        static bool locked = true;
+
+        // Hooks are registered for every world, they are removed at the end of the case
+        World::OnAdd<Total>([](EntityReference entity, Total* total)
+        {
+            added += total->x;
+            locked = locked && !entity.Remove<Total>();
+        });
+        World::OnRemove<Total>([](EntityReference, Total* total) { removed += total->x; });
+
+        EntityReference created = World::CreateEntity([](Value*, Total* total) { total->x = 1; });
+        EntityReference plain = World::CreateEntity([](Value* value) { value->x = 0; });
+        CHECK(plain.Add([](Total* total) { total->x = 10; }));
+        CHECK(added == 11);
+        CHECK(locked);
+        CHECK(ReadTotal(created) == 1);
+
+        CHECK(plain.Remove<Total>());
+        CHECK(removed == 10);
+        // Removing a missing component succeeds without a transition
+        CHECK(plain.Remove<Total>());
+        CHECK(removed == 10);
+
+        CommandBuffer buffer;
+        buffer.Create([](Total* total) { total->x = 100; });
+        buffer.Destroy(created);
+        buffer.Destroy(plain);
+        CHECK(buffer.Flush());
+        CHECK(added == 111);
+        CHECK(removed == 11);
+
+        World::OnAdd<Total>(nullptr);
+        World::OnRemove<Total>(nullptr);
+        World::CreateEntity([](Total* total) { total->x = 1000; });
+        CHECK(added == 111);
+    });
+
+    Run("changed, ticks", []
+    {
+        const int rows = SECS_CHANGE_BLOCK_ROWS * 3;
+        static EntityReference entities[SECS_CHANGE_BLOCK_ROWS * 3];
+        for (int i = 0; i < rows; ++i)
+        {
+            entities[i] = World::CreateEntity([i](Speed* speed) { speed->x = i; });
+        }
+
+        World::EntityIterator sync;
+        auto visited = [&sync]
+        {
+            int count = 0;
+            sync.Iterate<Changed<Speed>>([&count](const Speed*) { count++; });
+            return count;
+        };
+        CHECK(visited() == rows);
+        CHECK(visited() == 0);
+
+        // A write marks its whole block, reads mark nothing
+        entities[SECS_CHANGE_BLOCK_ROWS + 1].Access([](Speed* speed) { speed->x = -1; });
+        entities[0].Access([](const Speed*) {});
+        CHECK(visited() == SECS_CHANGE_BLOCK_ROWS);
+        CHECK(visited() == 0);
+
+        // Another iterator starts from its own tick, its reads mark nothing either
+        World::EntityIterator other;
+        int count = 0;
+        other.Iterate<Changed<Speed>>([&count](const Speed*) { count++; });
+        CHECK(count == rows);
+        CHECK(visited() == 0);
+
+        // Non-const parameters mark every row they visit
+        other.Iterate([](Speed* speed) { speed->x++; });
+        CHECK(visited() == rows);
+    });
+
+    Run("view, revalidation", []
+    {
+        EntityReference first = World::CreateEntity([](Value* value) { value->x = 1; });
+        EntityReference entity = World::CreateEntity([](Value* value) { value->x = 2; });
+        View<Value> view(entity);
+        auto read = [&view]
+        {
+            int x = -1;
+            view.Access([&x](const Value* value) { x = value->x; });
+            return x;
+        };
+        CHECK(read() == 2);
+
+        // The entity is moved into the row of the destroyed one
+        first.Destroy();
+        CHECK(read() == 2);
+
+        // Growing the archetype moves its storage
+        for (int i = 0; i < 1000; ++i)
+        {
+            World::CreateEntity([i](Value* value) { value->x = i + 10; });
+        }
+        CHECK(read() == 2);
+
+        CHECK(view.Access([](Value* value) { value->x = 3; }));
+        CHECK(Read(entity) == 3);
+
+        CHECK(entity.Add([](Total* total) { total->x = 30; }));
+        CHECK(read() == 3);
+        View<const Total, Value> both(entity);
+        int sum = 0;
+        CHECK(both.Access([&sum](const Value* value, const Total* total) { sum = value->x + total->x; }));
+        CHECK(sum == 33);
+
+        CHECK(entity.Remove<Value>());
+        CHECK(!view.Access([](const Value*) {}));
+        CHECK(!both.Access([](const Total*) {}));
+
+        View<Total> total(entity);
+        CHECK(total.Access([](const Total*) {}));
+        entity.Destroy();
+        CHECK(!total.Access([](const Total*) {}));
+    });
+
+    Run("stats, first run", []
+    {
+        // {Value, Total} is matched by every query below and holds no entity
+        EntityReference entity = World::CreateEntity([](Value* value) { value->x = 1; });
+        EntityReference gone = World::CreateEntity([](Value*, Total*) {});
+        gone.Destroy();
+        CHECK(entity.Add([](Mark* mark) { mark->x = 1; }));
+
+        World::EntityIterator iterator;
+        auto fused = [](const Value*) {};
+        auto both = [](const Value*, const Total*) {};
+        iterator.IterateFused(fused, both);
+        CHECK(World::GetQueryStats<decltype(fused)>().iterations == 1);
+        CHECK(World::GetQueryStats<decltype(fused)>().archetypesSkipped == 1);
+        CHECK(World::GetQueryStats<decltype(both)>().archetypesSkipped == 1);
+
+        // The same query, whatever the order and const qualifiers of the parameters
+        auto iterate = [](Value*) {};
+        iterator.Iterate(iterate);
+        CHECK(World::GetQueryStats<decltype(iterate)>().iterations == 2);
+        CHECK(World::GetQueryStats<decltype(iterate)>().archetypesSkipped == 2);
+
+        auto scheduled = [](Total*) {};
+        Schedule(scheduled).Run();
+        CHECK(World::GetQueryStats<decltype(scheduled)>().iterations == 1);
+        CHECK(World::GetQueryStats<decltype(scheduled)>().archetypesSkipped == 1);
+
+        auto sparse = [](const Value*, const Mark*) {};
+        iterator.Iterate(sparse);
+        CHECK(World::GetQueryStats<decltype(sparse)>().iterations == 1);
+        CHECK(World::GetQueryStats<decltype(sparse)>().archetypesSkipped == 1);
+        CHECK(World::GetQueryStats<decltype(sparse)>().rowsVisited == 1);
+    });
+
+    Run("parallel, nested dispatch", []
+    {
+        // The Total archetype needs more jobs than the outer dispatch, regrowing the job list
+        for (int i = 0; i < 10; ++i)
+        {
+            World::CreateEntity([i](Value* value) { value->x = i; });
+            World::CreateEntity([i](Value* value, Total* total) { value->x = i; total->x = i; });
+        }
+        CHECK(World::CreateEntities(20000, [](Total* total) { total->x = 1; }) == 20000);
+
+        // Counted without synchronization, the serial executor runs the jobs on this thread
+        int visited = 0;
+        int nested = 0;
+        CHECK(World::IterateParallel([&visited, &nested](Value* value)
+        {
+            value->x++;
+            visited++;
+            nested += World::IterateParallel([](const Total*) {});
+            nested += Schedule([](const Total*) {}).Run();
+        }));
+        CHECK(visited == 20);
+        CHECK(nested == 0);
+
+        int sum = 0;
+        World::EntityIterator iterator;
+        iterator.Iterate([&sum](const Value* value) { sum += value->x; });
+        CHECK(sum == 2 * (45 + 10));
+    });
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file regression.cpp
+ * @brief Regression checks for fixed SECS bugs
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * Each case reproduces a bug that was fixed, in a fresh World, and checks the
+ * behaviour that used to fail. The program prints the failed checks and exits
+ * with a non-zero status if there are any. Build it with sanitizers to catch
+ * out of bounds accesses as well, see the Makefile.
+ *
+ * - **compact, stale reference**: Compact() after destroying the only entity
+ *   must keep the record guarding its reference
+ * - **compact, reused record**: an entity created after Compact() must not be
+ *   reachable through a reference to the entity destroyed before it
+ * - **load, entity past the image**: Snapshot::Load() must release entities
+ *   created in records the image does not hold
+ * - **load, record free in the image**: an entity created in a record that
+ *   was free when saving must not be reachable after loading
+ * - **hierarchy, link added directly**: an entity created with ChildOf must
+ *   get its depth, and be visited after its parent
+ * - **sparse, removing another entity**: a sparse iteration removing the
+ *   component of an entity it did not reach yet must visit every other entity once
+ * - **sparse, filter terms**: With and Without filters naming sparse
+ *   components must select entities by what they hold
+ */
+
+#include <stdint.h>
+
+#include "Check.hpp"
+
+struct Total { int x; };
+struct Mark { int x; };
+
+template <> struct SECS::SparseStorage<Mark> : std::true_type {};
+
+int main()
+{
+    Run("compact, stale reference", []
+    {
+        EntityReference entity = World::CreateEntity([](Value* value) { value->x = 1; });
+        EntityReference stale = entity;
+        entity.Destroy();
+        CHECK(World::Compact());
+        CHECK(Read(stale) == -1);
+        CHECK(!stale.Remove<Value>());
+    });
+
+    Run("compact, reused record", []
+    {
+        EntityReference a = World::CreateEntity([](Value* value) { value->x = 1; });
+        EntityReference b = World::CreateEntity([](Value* value) { value->x = 2; });
+        EntityReference stale = b;
+        b.Destroy();
+        CHECK(World::Compact());
+        EntityReference c = World::CreateEntity([](Value* value) { value->x = 3; });
+        CHECK(Read(a) == 1);
+        CHECK(Read(stale) == -1);
+        CHECK(Read(c) == 3);
+    });
+
+    Run("load, entity past the image", []
+    {
+        static uint8_t image[1024];
+        EntityReference a = World::CreateEntity([](Value* value) { value->x = 1; });
+        const size_t used = Snapshot::Save(image, sizeof(image));
+        CHECK(used != 0);
+        EntityReference b = World::CreateEntity([](Value* value) { value->x = 2; });
+        CHECK(Snapshot::Load(image, used));
+        CHECK(Read(a) == 1);
+        CHECK(Read(b) == -1);
+        EntityReference c = World::CreateEntity([](Value* value) { value->x = 3; });
+        CHECK(Read(b) == -1);
+        CHECK(Read(c) == 3);
+    });
+
+    Run("load, record free in the image", []
+    {
+        static uint8_t image[1024];
+        EntityReference a = World::CreateEntity([](Value* value) { value->x = 1; });
+        World::CreateEntity([](Value* value) { value->x = 2; });
+        a.Destroy();
+        const size_t used = Snapshot::Save(image, sizeof(image));
+        CHECK(used != 0);
+        EntityReference b = World::CreateEntity([](Value* value) { value->x = 3; });
+        CHECK(Snapshot::Load(image, used));
+        CHECK(Read(b) == -1);
+        EntityReference c = World::CreateEntity([](Value* value) { value->x = 4; });
+        CHECK(Read(b) == -1);
+        CHECK(Read(c) == 4);
+    });
+
+    Run("hierarchy, link added directly", []
+    {
+        auto propagate = [](const Total* parent, const Value* value, Total* total)
+        {
+            total->x = (parent ? parent->x : 0) + value->x;
+        };
+
+        EntityReference root = World::CreateEntity([](Value* value, Total*) { value->x = 1000; });
+        EntityReference child = World::CreateEntity([](Value* value, Total*) { value->x = 100; });
+        CHECK(World::SetParent(child, root));
+
+        World::EntityIterator iterator;
+        CHECK(iterator.IterateHierarchy(propagate));
+
+        EntityReference grandchild = World::CreateEntity([child](Value* value, Total*, ChildOf* link)
+        {
+            value->x = 10;
+            link->parent = child;
+        });
+        root.Access([](Value* value) { value->x = 2000; });
+        CHECK(iterator.IterateHierarchy(propagate));
+
+        int x = -1;
+        grandchild.Access([&x](const Total* total) { x = total->x; });
+        CHECK(x == 2110);
+    });
+
+    Run("sparse, removing another entity", []
+    {
+        EntityReference entities[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            entities[i] = World::CreateEntity([i](Value* value) { value->x = i; });
+            CHECK(entities[i].Add([i](Mark* mark) { mark->x = i; }));
+        }
+
+        int visits[8] = {};
+        World::EntityIterator iterator;
+        iterator.Iterate([&visits, &entities](const Mark* mark)
+        {
+            visits[mark->x]++;
+            if (mark->x != 0) { entities[0].Remove<Mark>(); }
+        });
+
+        for (int i = 1; i < 8; ++i)
+        {
+            CHECK(visits[i] == 1);
+        }
+        CHECK(visits[0] <= 1);
+    });
+
+    Run("sparse, filter terms", []
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            EntityReference entity = World::CreateEntity([i](Value* value) { value->x = i; });
+            if (i % 2) { CHECK(entity.Add<Mark>()); }
+        }
+
+        int with = 0;
+        int without = 0;
+        World::EntityIterator iterator;
+        iterator.Iterate<With<Mark>>([&with](const Value* value) { with += value->x; });
+        iterator.Iterate<Without<Mark>>([&without](const Value* value) { without += value->x; });
+        CHECK(with == 1 + 3 + 5);
+        CHECK(without == 0 + 2 + 4);
+    });
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,295 @@
+/**
+ * @file snapshot.cpp
+ * @brief Checks of Snapshot::Load() on valid and damaged images
+ * @author Roberto Duarte
+ * @date 2025
+ * @copyright MIT License
+ *
+ * @details
+ * Each case saves a small world holding several archetypes, a tag and freed
+ * records, then loads the image back, either as saved or damaged. Damaged
+ * images must be rejected without touching the world. Build the checks with
+ * each storage configuration, e.g. SECS_FLAGS="-DSECS_CHUNK_SIZE=256" or
+ * SECS_FLAGS="-DSECS_COMPONENT_WORDS=2", see the Makefile.
+ *
+ * - **round trip**: values, tags, references and freed records are restored,
+ *   and saving again gives the same image
+ * - **truncated image**: every shorter prefix is rejected
+ * - **bad header**: a wrong magic, version or Index width is rejected
+ * - **corrupt block**: a wrong column size or an out of range record is rejected
+ * - **duplicate row**: two records sharing a row are rejected
+ * - **cyclic free list**: a free list looping back on itself is rejected
+ * - **sparse components**: a world holding sparse components cannot be saved,
+ *   and those added after the save are dropped by loading
+ * - **older version**: a reference taken after the save fails once the record
+ *   it points to is released at its version again
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Check.hpp"
+
+struct Total { int x; };
+struct Flag {};
+struct Mark { int x; };
+
+template <> struct SECS::SparseStorage<Mark> : std::true_type {};
+
+/**
+ * @brief Leading block of an image, mirroring the layout documented in Snapshot.hpp.
+ */
+struct Header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t idBytes;
+    uint32_t indexBytes;
+    uint32_t archetypeCount;
+    uint64_t recordCount;
+    uint64_t freeHead;
+    uint64_t freeCount;
+};
+
+/**
+ * @brief An entity record of an image, mirroring EntityRecord.
+ */
+struct Record
+{
+    Index archetype;
+    Index row;
+    Index version;
+};
+
+static_assert(sizeof(Record) == sizeof(EntityRecord), "Record must mirror EntityRecord");
+
+/**
+ * @brief Leading block of the rows of one archetype, mirroring the layout documented in Snapshot.hpp.
+ */
+struct BlockHeader
+{
+    Component::BinaryId id;
+    uint64_t index;
+    uint64_t rows;
+};
+
+static uint8_t image[4096];
+static uint8_t damaged[4096];
+static size_t used = 0;
+static EntityReference entities[6];
+
+/**
+ * @brief Run a case in a fresh world holding the saved entities.
+ * @details Entities 1 and 3 are destroyed before saving, so the image holds a free list of two
+ * records. Entities 0, 2 and 4 hold Value, 2 and 4 also hold Total and 4 holds the Flag tag.
+ * @param name The name printed for the case.
+ * @param body The case.
+ */
+template <typename Body>
+static void RunSaved(const char* name, Body body)
+{
+    Run(name, [&body]
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            entities[i] = World::CreateEntity([i](Value* value) { value->x = i; });
+        }
+        CHECK(entities[2].Add([](Total* total) { total->x = 20; }));
+        CHECK(entities[4].Add([](Total* total) { total->x = 40; }));
+        CHECK(entities[4].Add<Flag>());
+        EntityReference first = entities[1];
+        EntityReference second = entities[3];
+        first.Destroy();
+        second.Destroy();
+
+        used = Snapshot::Save(image, sizeof(image));
+        CHECK(used != 0);
+        memcpy(damaged, image, used);
+        body();
+    });
+}
+
+/**
+ * @brief Get a record of the damaged image.
+ * @param index The record index.
+ * @return A pointer to the record, copy it before reading since records are not aligned.
+ */
+static uint8_t* RecordAt(size_t index)
+{
+    return damaged + sizeof(Header) + sizeof(Record) * index;
+}
+
+/**
+ * @brief Check that the damaged image is rejected and the world left as it was.
+ */
+static void CheckRejected()
+{
+    entities[0].Access([](Value* value) { value->x = 100; });
+    CHECK(!Snapshot::Load(damaged, used));
+    CHECK(Read(entities[0]) == 100);
+    CHECK(Read(entities[2]) == 2);
+}
+
+int main()
+{
+    RunSaved("round trip", []
+    {
+        entities[0].Access([](Value* value) { value->x = 100; });
+        EntityReference gone = entities[2];
+        gone.Destroy();
+        EntityReference created = World::CreateEntity([](Value* value) { value->x = 7; });
+
+        CHECK(Snapshot::Load(image, used));
+        CHECK(Read(entities[0]) == 0);
+        CHECK(Read(entities[2]) == 2);
+        CHECK(Read(entities[4]) == 4);
+        CHECK(Read(entities[1]) == -1);
+        CHECK(Read(created) == -1);
+
+        int total = 0;
+        int flagged = 0;
+        World::EntityIterator iterator;
+        iterator.Iterate([&total](const Total* value) { total += value->x; });
+        iterator.Iterate<With<Flag>>([&flagged](const Value* value) { flagged += value->x; });
+        CHECK(total == 60);
+        CHECK(flagged == 4);
+
+        static uint8_t again[4096];
+        CHECK(Snapshot::Save(again, sizeof(again)) == used);
+        CHECK(memcmp(again, image, used) == 0);
+
+        // The two freed records are reused before the table grows
+        World::CreateEntity([](Value* value) { value->x = 8; });
+        World::CreateEntity([](Value* value) { value->x = 9; });
+        CHECK(Snapshot::Save(again, sizeof(again)) != 0);
+        Header header;
+        memcpy(&header, again, sizeof(header));
+        CHECK(header.recordCount == 6);
+        CHECK(header.freeCount == 0);
+    });
+
+    RunSaved("truncated image", []
+    {
+        entities[0].Access([](Value* value) { value->x = 100; });
+        for (size_t size = 0; size < used; ++size)
+        {
+            CHECK(!Snapshot::Load(image, size));
+        }
+        CHECK(Read(entities[0]) == 100);
+    });
+
+    RunSaved("bad header", []
+    {
+        Header header;
+        memcpy(&header, image, sizeof(header));
+
+        Header wrong = header;
+        wrong.magic++;
+        memcpy(damaged, &wrong, sizeof(wrong));
+        CheckRejected();
+
+        wrong = header;
+        wrong.version++;
+        memcpy(damaged, &wrong, sizeof(wrong));
+        CheckRejected();
+
+        wrong = header;
+        wrong.indexBytes *= 2;
+        memcpy(damaged, &wrong, sizeof(wrong));
+        CheckRejected();
+    });
+
+    RunSaved("corrupt block", []
+    {
+        Header header;
+        memcpy(&header, image, sizeof(header));
+        const size_t block = sizeof(Header) + sizeof(Record) * header.recordCount;
+        const size_t columns = block + sizeof(BlockHeader);
+
+        // The first archetype holds Value only, its column size is followed by the record indices
+        uint32_t size;
+        memcpy(&size, damaged + columns, sizeof(size));
+        size++;
+        memcpy(damaged + columns, &size, sizeof(size));
+        CheckRejected();
+
+        memcpy(damaged, image, used);
+        const Index record = static_cast<Index>(header.recordCount);
+        memcpy(damaged + columns + sizeof(uint32_t), &record, sizeof(record));
+        CheckRejected();
+    });
+
+    RunSaved("duplicate row", []
+    {
+        // Entity 0 claims the row of entity 5, both are alone in the Value archetype
+        Record zero;
+        Record five;
+        memcpy(&zero, RecordAt(0), sizeof(zero));
+        memcpy(&five, RecordAt(5), sizeof(five));
+        CHECK(zero.archetype == five.archetype);
+        zero.row = five.row;
+        memcpy(RecordAt(0), &zero, sizeof(zero));
+        CheckRejected();
+    });
+
+    RunSaved("cyclic free list", []
+    {
+        Header header;
+        memcpy(&header, image, sizeof(header));
+        CHECK(header.freeCount == 2);
+
+        // The head links to the other freed record, which now links back to the head
+        Record head;
+        memcpy(&head, RecordAt(header.freeHead), sizeof(head));
+        Record next;
+        memcpy(&next, RecordAt(head.row), sizeof(next));
+        const Index tail = head.row;
+        next.row = static_cast<Index>(header.freeHead);
+        memcpy(RecordAt(tail), &next, sizeof(next));
+        CheckRejected();
+    });
+
+    RunSaved("sparse components", []
+    {
+        CHECK(entities[0].Add([](Mark* mark) { mark->x = 1; }));
+        CHECK(Snapshot::Size() == 0);
+        CHECK(Snapshot::Save(damaged, sizeof(damaged)) == 0);
+        CHECK(Snapshot::Load(image, used));
+
+        int marked = 0;
+        World::EntityIterator iterator;
+        iterator.Iterate([&marked](const Mark*) { marked++; });
+        CHECK(marked == 0);
+        CHECK(Read(entities[0]) == 0);
+        CHECK(Snapshot::Size() == used);
+    });
+
+    Run("older version", []
+    {
+        // f reuses the record of e, loading gives the record back the version of e
+        EntityReference e = World::CreateEntity([](Value* value) { value->x = 1; });
+        used = Snapshot::Save(image, sizeof(image));
+        CHECK(used != 0);
+        EntityReference gone = e;
+        gone.Destroy();
+        EntityReference f = World::CreateEntity([](Value* value) { value->x = 2; });
+        CHECK(Snapshot::Load(image, used));
+        CHECK(Read(e) == 1);
+        CHECK(Read(f) == -1);
+
+        // Releasing the record brings its version to the one of f
+        e.Destroy();
+        CHECK(Read(f) == -1);
+        CHECK(!f.Add([](Total* total) { total->x = 3; }));
+        CHECK(!f.Remove<Value>());
+        View<Value> view(f);
+        CHECK(!view.Access([](Value*) {}));
+        CommandBuffer buffer;
+        buffer.Destroy(f);
+        buffer.Flush();
+        f.Destroy();
+        CHECK(Read(f) == -1);
+    });
+
+    return failures ? 1 : 0;
+}